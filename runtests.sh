@@ -12,3 +12,23 @@ do
         break
     fi
 done
+
+# Frames rasterized by --frame-jobs must match the frames drawn in sequence
+for file in input/tests/framejobstest*.cfdg
+do
+    rm -f output/seq_*.png output/par_*.png
+    ./cfdg -q -s 300 -a 12 "$file" output/seq.png &&
+    ./cfdg -q -s 300 -a 12 --frame-jobs 2 "$file" output/par.png
+    status=$?
+    for frame in output/seq_*.png
+    do
+        cmp -s "$frame" "output/par_${frame#output/seq_}" || status=1
+    done
+    if [ $status -eq 0 ]
+    then
+        echo "$file --frame-jobs   pass"
+    else
+        echo "$file --frame-jobs          FAIL: $status"
+        break
+    fi
+done
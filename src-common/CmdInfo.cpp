@@ -49,8 +49,11 @@ namespace AST {
     CommandInfo::tryInit(unsigned i, ASTcompiledPath* path, double w, const ASTpathCommand* c)
     {
         // Try to change the path UID from the default value to a value that is 
-        // guaranteed to not be in use. If successful then perform initialization
-        if (mPathUID.compare_exchange_strong(PathUIDDefault, 0ULL))
+        // guaranteed to not be in use. If successful then perform initialization.
+        // A failed exchange overwrites the expected value, so it must not be
+        // the shared default.
+        UIDdatatype expected = PathUIDDefault;
+        if (mPathUID.compare_exchange_strong(expected, 0ULL))
             init(i, path, w, c);
     }
 
@@ -68,21 +71,21 @@ namespace AST {
 
             mIndex = i;
             mPath = &(path->mPath);
-            mPathUID = path->mPathUID.load();              // this step must be last
             mStrokeWidth = w;
+            mPathUID = path->mPathUID.load();              // this step must be last
         }
     }
     
     CommandInfo::CommandInfo(CommandInfo&& from) noexcept
     : mFlags(from.mFlags), mMiterLimit(from.mMiterLimit),
       mStrokeWidth(from.mStrokeWidth), mIndex(from.mIndex), mPath(from.mPath),
-      mPathUID(from.mPathUID.load())
+      mPathUID(from.mPathUID.load()), mHull(std::move(from.mHull))
     { }
 
     CommandInfo::CommandInfo(const CommandInfo& from)
     : mFlags(from.mFlags), mMiterLimit(from.mMiterLimit),
       mStrokeWidth(from.mStrokeWidth), mIndex(from.mIndex), mPath(from.mPath),
-      mPathUID(from.mPathUID.load())
+      mPathUID(from.mPathUID.load()), mHull(from.mHull)
     { }
     
     CommandInfo&
@@ -95,6 +98,7 @@ namespace AST {
         mIndex = from.mIndex;
         mPath = from.mPath;
         mPathUID = from.mPathUID.load();
+        mHull = std::move(from.mHull);
         return *this;
     }
     
@@ -108,6 +112,7 @@ namespace AST {
         mIndex = from.mIndex;
         mPath = from.mPath;
         mPathUID = from.mPathUID.load();
+        mHull = from.mHull;
         return *this;
     }
     
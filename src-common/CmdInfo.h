@@ -34,6 +34,8 @@
 #include "agg2/agg_path_storage.h"
 #include <deque>
 #include <atomic>
+#include <memory>
+#include <vector>
 #include "ast.h"
 
 namespace AST {
@@ -51,6 +53,20 @@ namespace AST {
         UIDtype             mPathUID;
         static UIDdatatype  PathUIDDefault;
         
+        struct Hull {
+            UIDdatatype                 mPathUID;
+            int                         mFlags;
+            double                      mAccuracy;
+            double                      mAngleTolerance;
+            std::vector<agg::point_d>   mPoints;
+        };
+        mutable std::shared_ptr<const Hull>
+                            mHull;
+            // local-space convex hull of the flattened (and stroked) path,
+            // built by pathIterator::localHull() and only valid while its
+            // path UID and flags match this command's and it was flattened
+            // at the same accuracy
+        
         static const CommandInfo
                             Default;
         
@@ -72,6 +72,8 @@ struct HSBColor
     bool operator!=(const HSBColor& hsb) const {
         return h != hsb.h || s != hsb.s || b != hsb.b || a != hsb.s;
     }
+    bool isZero() const { return h == 0.0 && s == 0.0 && b == 0.0 && a == 0.0; }
+        // an adjustment of zero leaves a color unchanged
 
     double h = 0, s = 0, b = 0, a = 0;
     
@@ -27,7 +27,7 @@
 #include "myrandom.h"
 #include <cstddef>
 
-Rand64 Rand64::Common;
+thread_local Rand64 Rand64::Common;
 
 // Return int in [l,u]
 int64_t Rand64::getInt(int64_t l, int64_t u)
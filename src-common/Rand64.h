@@ -109,7 +109,7 @@ public:
 
 private:
     XORshift64star  mSeed;
-    static Rand64   Common;
+    static thread_local Rand64 Common;
     static double prob(double p) { return p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p); };
     static double pos(double p) { return p > 0.0 ? p : std::numeric_limits<double>::epsilon(); }
     static double degree(double n) { return n >= 1.0 ? std::floor(n) : 1.0; }
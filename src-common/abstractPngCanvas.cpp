@@ -38,7 +38,8 @@ abstractPngCanvas::abstractPngCanvas(const char* outfilename, bool quiet, int wi
                                      aggCanvas::PixelFormat pixfmt, bool crop, int frameCount,
                                      int variation, bool wallpaper, Renderer *r, int mx, int my)
 : aggCanvas(pixfmt), mOutputFileName(outfilename), mFrameCount(frameCount), 
-  mCurrentFrame(1), mVariation(variation), mPixelFormat(pixfmt),
+  mCurrentFrame(1), mVariation(variation),
+  mPixelFormat(static_cast<PixelFormat>(pixfmt & ~Has_Float_Accum)),
   mCrop(crop), mQuiet(quiet), mWallpaper(wallpaper), mRenderer(r), mFullWidth(width), 
   mFullHeight(height), mOriginX(0), mOriginY(0)
 {
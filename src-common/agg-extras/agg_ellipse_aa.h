@@ -0,0 +1,230 @@
+// agg_ellipse_aa.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2006-2015 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+//----------------------------------------------------------------------------
+//
+// class ellipse_aa
+//
+// Draws an affine transformed circle straight into a renderer_base, without
+// polygonizing it and running it through the scanline rasterizer. Each
+// scanline is solved analytically for the interior of the ellipse, which is
+// drawn as a solid hline. The anti-aliased fringe on either side is computed
+// from the approximate distance of each pixel center to the ellipse edge.
+// Works with any pixel format that renderer_base works with, including the
+// custom blend pixel formats.
+//
+//----------------------------------------------------------------------------
+
+#ifndef AGG_ELLIPSE_AA_INCLUDED
+#define AGG_ELLIPSE_AA_INCLUDED
+
+#include "agg2/agg_basics.h"
+#include "agg2/agg_trans_affine.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+namespace agg
+{
+
+    class ellipse_aa
+    {
+    public:
+        enum { min_radius = 4 };
+            // smaller ellipses are better served by the scanline rasterizer
+
+        ellipse_aa() = default;
+
+        bool init(const trans_affine& mtx, double radius = 0.5);
+            // ellipse is a circle at the origin, transformed by mtx. Returns
+            // false if the ellipse is too small or too thin to draw analytically.
+
+        template<class BaseRenderer, class ColorT>
+        void render(BaseRenderer& ren, const ColorT& c);
+
+    private:
+        bool span(double y, double* x1, double* x2) const;
+        cover_type cover(double dx, double dy) const;
+
+        template<class BaseRenderer, class ColorT>
+        void fringe(BaseRenderer& ren, const ColorT& c, int x1, int x2, int y);
+
+        double m_cx = 0.0, m_cy = 0.0;  // center
+        double m_r2 = 0.0;              // radius squared
+        double m_radius = 0.0;
+        double m_i00 = 0.0, m_i01 = 0.0, m_i10 = 0.0, m_i11 = 0.0;
+                                        // inverse of the linear part
+        double m_qa = 0.0, m_qb = 0.0;  // quadratic form of the inverse
+        double m_det = 0.0;             // determinant of the quadratic form
+        point_d m_right;                // rightmost point, relative to center
+        point_d m_bottom;               // bottommost point, relative to center
+        std::vector<cover_type> m_covers;
+    };
+
+    inline bool ellipse_aa::init(const trans_affine& mtx, double radius)
+    {
+        double det = mtx.sx * mtx.sy - mtx.shy * mtx.shx;
+        if (!std::isfinite(det) || std::fabs(det) < 1e-12)
+            return false;
+
+        // The smallest semi-axis is the radius times the smallest singular
+        // value of the linear part.
+        double t = mtx.sx * mtx.sx + mtx.shx * mtx.shx +
+                   mtx.shy * mtx.shy + mtx.sy * mtx.sy;
+        double s = std::sqrt(std::max(t * t - 4.0 * det * det, 0.0));
+        double minAxis = radius * std::sqrt(std::max((t - s) * 0.5, 0.0));
+        if (!(minAxis >= min_radius) || !std::isfinite(t))
+            return false;
+
+        m_cx = mtx.tx;
+        m_cy = mtx.ty;
+        m_radius = radius;
+        m_r2 = radius * radius;
+        m_i00 =  mtx.sy  / det;
+        m_i01 = -mtx.shx / det;
+        m_i10 = -mtx.shy / det;
+        m_i11 =  mtx.sx  / det;
+
+        // Ellipse is the set of points d (relative to the center) where
+        // qa*dx^2 + 2*qb*dx*dy + qc*dy^2 <= r^2, and
+        // qa*qc - qb^2 = 1/det^2
+        m_qa = m_i00 * m_i00 + m_i10 * m_i10;
+        m_qb = m_i00 * m_i01 + m_i10 * m_i11;
+        m_det = 1.0 / (det * det);
+
+        double w = std::sqrt(mtx.sx * mtx.sx + mtx.shx * mtx.shx);
+        double h = std::sqrt(mtx.shy * mtx.shy + mtx.sy * mtx.sy);
+        double cross = mtx.sx * mtx.shy + mtx.shx * mtx.sy;
+        m_right.x  = radius * w;
+        m_right.y  = radius * cross / w;
+        m_bottom.x = radius * cross / h;
+        m_bottom.y = radius * h;
+        return true;
+    }
+
+    inline bool ellipse_aa::span(double y, double* x1, double* x2) const
+    // Horizontal extent of the ellipse on the line y
+    {
+        double dy = y - m_cy;
+        double disc = m_qa * m_r2 - dy * dy * m_det;
+        if (disc < 0.0) return false;
+        disc = std::sqrt(disc);
+        *x1 = m_cx + (-m_qb * dy - disc) / m_qa;
+        *x2 = m_cx + (-m_qb * dy + disc) / m_qa;
+        return true;
+    }
+
+    inline cover_type ellipse_aa::cover(double dx, double dy) const
+    // Coverage of the pixel centered at dx,dy from the center, using the
+    // distance to the edge estimated from the gradient
+    {
+        double qx = m_i00 * dx + m_i01 * dy;
+        double qy = m_i10 * dx + m_i11 * dy;
+        double q = std::sqrt(qx * qx + qy * qy);
+        double nx = m_i00 * qx + m_i10 * qy;
+        double ny = m_i01 * qx + m_i11 * qy;
+        double n = std::sqrt(nx * nx + ny * ny);
+        if (n == 0.0) return cover_full;
+        double a = 0.5 - (q - m_radius) * q / n;
+        if (a <= 0.0) return 0;
+        if (a >= 1.0) return cover_full;
+        return static_cast<cover_type>(uround(a * cover_full));
+    }
+
+    template<class BaseRenderer, class ColorT>
+    void ellipse_aa::fringe(BaseRenderer& ren, const ColorT& c, int x1, int x2, int y)
+    {
+        if (x2 < x1) return;
+        m_covers.resize(static_cast<unsigned>(x2 - x1 + 1));
+        double dy = y + 0.5 - m_cy;
+        for (int x = x1; x <= x2; ++x)
+            m_covers[x - x1] = cover(x + 0.5 - m_cx, dy);
+
+        // Trim uncovered pixels from the ends
+        int first = 0, last = x2 - x1;
+        while (first <= last && m_covers[first] == 0) ++first;
+        while (last >= first && m_covers[last] == 0) --last;
+        if (first <= last)
+            ren.blend_solid_hspan(x1 + first, y, last - first + 1, c, &m_covers[first]);
+    }
+
+    template<class BaseRenderer, class ColorT>
+    void ellipse_aa::render(BaseRenderer& ren, const ColorT& c)
+    {
+        // Clamp to the clip box before converting to int
+        double xmin = ren.xmin(), xmax = ren.xmax();
+        int y1 = ifloor(std::max(m_cy - m_bottom.y, static_cast<double>(ren.ymin())));
+        int y2 = ifloor(std::min(m_cy + m_bottom.y, static_cast<double>(ren.ymax())));
+
+        // Each pixel row is the band between two lines. The part of the
+        // ellipse inside the band is convex, so its horizontal extent is set
+        // by where the lines cross the ellipse and by any extreme points of
+        // the ellipse that lie in the band. Pixels entirely inside both line
+        // crossings are fully covered.
+        double l1 = 0.0, r1 = 0.0, l2 = 0.0, r2 = 0.0;
+        bool in1 = span(y1, &l1, &r1), in2 = false;
+        for (int y = y1; y <= y2; ++y, in1 = in2, l1 = l2, r1 = r2) {
+            in2 = span(y + 1.0, &l2, &r2);
+
+            double outerL = 1e300, outerR = -1e300;
+            auto extent = [&](double x) {
+                outerL = std::min(outerL, x);
+                outerR = std::max(outerR, x);
+            };
+            auto inBand = [&](double py) { return py >= y && py <= y + 1.0; };
+            if (in1) { extent(l1); extent(r1); }
+            if (in2) { extent(l2); extent(r2); }
+            if (inBand(m_cy + m_right.y))  extent(m_cx + m_right.x);
+            if (inBand(m_cy - m_right.y))  extent(m_cx - m_right.x);
+            if (inBand(m_cy + m_bottom.y)) extent(m_cx + m_bottom.x);
+            if (inBand(m_cy - m_bottom.y)) extent(m_cx - m_bottom.x);
+            if (outerL > outerR) continue;
+
+            int x1 = ifloor(std::max(outerL, xmin));
+            int x2 = ifloor(std::min(outerR, xmax));
+            if (x2 < x1) continue;
+
+            int ix1 = x2 + 1, ix2 = x2;         // empty interior
+            if (in1 && in2) {
+                double innerL = std::max(l1, l2);
+                double innerR = std::min(r1, r2);
+                int i1 = iceil(std::max(innerL, xmin));
+                int i2 = ifloor(std::min(innerR, xmax + 1.0)) - 1;
+                if (i1 <= i2) {
+                    ix1 = i1;
+                    ix2 = i2;
+                }
+            }
+
+            fringe(ren, c, x1, ix1 - 1, y);
+            if (ix1 <= ix2) {
+                ren.blend_hline(ix1, y, ix2, c, cover_full);
+                fringe(ren, c, ix2 + 1, x2, y);
+            }
+        }
+    }
+
+}
+
+#endif
@@ -38,13 +38,20 @@
 #include "agg2/agg_rasterizer_scanline_aa.h"
 #include "agg2/agg_scanline_p.h"
 #include "agg_fast_ellipse.h"
+#include "agg_ellipse_aa.h"
+#include "blendSpans.h"
 #include "agg2/agg_trans_affine.h"
 #include "agg_copy_rect.h"
 #include "primShape.h"
 #include "ast.h"
 #include "CmdInfo.h"
 #include "pathIterator.h"
-#include <set>
+#include "colorPalette.h"
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
 #include <cassert>
 
 #ifdef _WIN32
@@ -55,8 +62,8 @@ using color24_pixel_fmt = agg::pixfmt_bgr24_pre;
 
 using custom64_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba16, agg::order_bgra>;
 using custom32_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba8, agg::order_bgra>;
-using custom64_pixel_fmt = agg::pixfmt_custom_blend_rgba<custom64_blender, agg::rendering_buffer>;
-using custom32_pixel_fmt = agg::pixfmt_custom_blend_rgba<custom32_blender, agg::rendering_buffer>;
+using custom64_pixel_fmt = agg::pixfmt_span_blend_rgba<custom64_blender, agg::rendering_buffer>;
+using custom32_pixel_fmt = agg::pixfmt_span_blend_rgba<custom32_blender, agg::rendering_buffer>;
 #else
 using color64_pixel_fmt = agg::pixfmt_rgba64_pre;
 using color48_pixel_fmt = agg::pixfmt_rgb48_pre;
@@ -65,28 +72,39 @@ using color24_pixel_fmt = agg::pixfmt_rgb24_pre;
 
 using custom64_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba16, agg::order_rgba>;
 using custom32_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba8, agg::order_rgba>;
-using custom64_pixel_fmt = agg::pixfmt_custom_blend_rgba<custom64_blender, agg::rendering_buffer>;
-using custom32_pixel_fmt = agg::pixfmt_custom_blend_rgba<custom32_blender, agg::rendering_buffer>;
+using custom64_pixel_fmt = agg::pixfmt_span_blend_rgba<custom64_blender, agg::rendering_buffer>;
+using custom32_pixel_fmt = agg::pixfmt_span_blend_rgba<custom32_blender, agg::rendering_buffer>;
 
 using customav_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba8, agg::order_bgra>;
-using customav_pixel_fmt = agg::pixfmt_custom_blend_rgba<customav_blender, agg::rendering_buffer>;
+using customav_pixel_fmt = agg::pixfmt_span_blend_rgba<customav_blender, agg::rendering_buffer>;
 #endif
 
+static_assert(std::is_same<color64_pixel_fmt::order_type, aggCanvas::RGBAOrder>::value &&
+              std::is_same<color32_pixel_fmt::order_type, aggCanvas::RGBAOrder>::value &&
+              std::is_same<custom64_blender::order_type, aggCanvas::RGBAOrder>::value &&
+              std::is_same<custom32_blender::order_type, aggCanvas::RGBAOrder>::value &&
+              std::is_same<color48_pixel_fmt::order_type, aggCanvas::RGBOrder>::value &&
+              std::is_same<color24_pixel_fmt::order_type, aggCanvas::RGBOrder>::value,
+              "aggCanvas channel orders must match its pixel formats");
+
 using ff_pixel_fmt = agg::pixfmt_argb32_pre;
 using ff24_pixel_fmt = agg::pixfmt_rgb24_pre;
 using av_pixel_fmt = agg::pixfmt_bgra32_pre;
 
 using customff_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba8, agg::order_argb>;
-using customff_pixel_fmt = agg::pixfmt_custom_blend_rgba<customff_blender, agg::rendering_buffer>;
+using customff_pixel_fmt = agg::pixfmt_span_blend_rgba<customff_blender, agg::rendering_buffer>;
 
 using gray_pixel_fmt = agg::pixfmt_gray8_pre;
 using gray16_pixel_fmt = agg::pixfmt_gray16_pre;
 
+using float_blender = agg::comp_op_adaptor_rgba_pre<agg::rgba32, agg::order_rgba>;
+using float_pixel_fmt = agg::pixfmt_span_blend_rgba<float_blender, agg::rendering_buffer>;
+
 #ifndef M_PI
 #define M_PI        3.14159265358979323846
 #endif
 
-#define PNG8Limit 32
+#define QuantizeBandRows 64
 
 #define ADJ_SMALL_SIZE      5.000
 #define ADJ_CIRCLE_SIZE     0.30
@@ -142,6 +160,49 @@ namespace {
 
         return (sizex + sizey) / 2;
     }
+    
+    inline double
+    polygonRadius(double size)
+    // Average radius of the polygon that fast_ellipse draws for a unit circle
+    // with int(size)+8 steps, so that analytic circles have the same area
+    {
+        unsigned steps = static_cast<unsigned>(size) + 8;
+        steps += (-steps) & 7;
+        return 1.0 - (1.0 - cos(M_PI / steps)) * 2.0 / 3.0;
+    }
+    
+    inline bool
+    fitsPalette(const agg::rendering_buffer& buffer, unsigned pixWidth)
+    {
+        colorPalette palette(buffer.row_ptr(0), buffer.width(), buffer.height(),
+                             buffer.stride(), pixWidth);
+        return palette.fits();
+    }
+    
+    const float OrderedDither[4][4] = {
+        { 0.5f / 16,  8.5f / 16,  2.5f / 16, 10.5f / 16},
+        {12.5f / 16,  4.5f / 16, 14.5f / 16,  6.5f / 16},
+        { 3.5f / 16, 11.5f / 16,  1.5f / 16,  9.5f / 16},
+        {15.5f / 16,  7.5f / 16, 13.5f / 16,  5.5f / 16}
+    };
+    
+    template <class color_type>
+    inline color_type
+    quantize(const float* p, float dither)
+    // Premultiplied float pixel to integer color, dithered. Colors are
+    // clamped to the quantized alpha so that they stay premultiplied.
+    {
+        using value_type = typename color_type::value_type;
+        const float scale = static_cast<float>(color_type::base_mask);
+        auto q = [=](float v, float limit) {
+            return std::min(std::floor(std::max(v, 0.0f) * scale + dither), limit);
+        };
+        float a = q(p[3], scale);
+        return color_type(static_cast<value_type>(q(p[0], a)),
+                          static_cast<value_type>(q(p[1], a)),
+                          static_cast<value_type>(q(p[2], a)),
+                          static_cast<value_type>(a));
+    }
 };
 
 
@@ -155,6 +216,7 @@ class aggCanvas::impl {
         aggCanvas*          mCanvas;
     
         agg::fast_ellipse   unitEllipse;
+        agg::ellipse_aa     analyticEllipse;
         
         agg::trans_affine   unitTrans;
         primShape           unitSquare;
@@ -174,8 +236,6 @@ class aggCanvas::impl {
         int cropWidth;
         int cropHeight;
         
-        std::set<agg::int64u> pixelSet;
-        
         impl(aggCanvas* canvas)
             : buffer(), mCanvas(canvas), unitSquare(primShape::shapeMap[primShape::squareType]),
               shapeSquare(unitSquare, unitTrans),
@@ -192,6 +252,10 @@ class aggCanvas::impl {
         virtual void fill(RGBA8 bk) = 0;
         virtual void draw(RGBA8 c, agg::filling_rule_e fr = agg::fill_non_zero,
                           agg::comp_op_e blend = agg::comp_op_e::comp_op_src_over) = 0;
+        virtual void drawEllipse(RGBA8 c, agg::comp_op_e blend) = 0;
+            // draw analyticEllipse, bypassing the rasterizer
+        virtual void flush() {}
+            // bring the attached buffer up to date with the drawing
         
         virtual bool colorCount256() = 0;
         
@@ -227,6 +291,7 @@ template <class pixel_fmt> class aggPixelPainter : public aggCanvas::impl {
         void fill(RGBA8 bk) override;
         void draw(RGBA8 c, agg::filling_rule_e fr = agg::fill_non_zero,
                   agg::comp_op_e blend = agg::comp_op_e::comp_op_src_over) override;
+        void drawEllipse(RGBA8 c, agg::comp_op_e blend) override;
 
         bool colorCount256() override;
         
@@ -236,11 +301,102 @@ template <class pixel_fmt> class aggPixelPainter : public aggCanvas::impl {
         void draw(const aggCanvas& src, int x, int y) override;
 };
 
+template <class out_pixel_fmt> class aggFloatPainter : public aggPixelPainter<float_pixel_fmt> {
+    // Draws into a float RGBA buffer instead of the attached buffer, so
+    // overlapping translucent shapes don't pile up integer rounding error.
+    // The attached buffer is filled in by flush(), dithered to its format.
+    public:
+        using out_color = typename out_pixel_fmt::color_type;
+        using quant_color = typename std::conditional<sizeof(typename out_color::value_type) == 1,
+                                                      agg::rgba8, agg::rgba16>::type;
+    
+        std::vector<float>      accum;
+        agg::rendering_buffer   accumBuffer;
+        out_pixel_fmt           outFmt;
+    
+        aggFloatPainter(aggCanvas* canvas)
+        : aggPixelPainter<float_pixel_fmt>(canvas), outFmt(buffer)
+            { pixFmt.attach(accumBuffer); }
+        ~aggFloatPainter() = default;
+    
+        void reset() override;
+        void flush() override;
+        bool colorCount256() override
+            { return fitsPalette(buffer, out_pixel_fmt::pix_width); }
+        void draw(const aggCanvas& src, int x, int y) override;
+        using aggPixelPainter<float_pixel_fmt>::draw;
+    
+    private:
+        void quantizeRows(unsigned y1, unsigned y2);
+};
+
+template <class out_pixel_fmt>
+void
+aggFloatPainter<out_pixel_fmt>::reset()
+{
+    unsigned width = buffer.width();
+    unsigned height = buffer.height();
+    accum.assign(static_cast<std::size_t>(width) * height * 4, 0.0f);
+    accumBuffer.attach(reinterpret_cast<agg::int8u*>(accum.data()), width, height,
+                       static_cast<int>(width * 4 * sizeof(float)));
+    aggPixelPainter<float_pixel_fmt>::reset();
+    
+    // Start from whatever is in the attached buffer
+    for (unsigned y = 0; y < height; ++y) {
+        float* p = reinterpret_cast<float*>(accumBuffer.row_ptr(y));
+        for (unsigned x = 0; x < width; ++x, p += 4) {
+            agg::rgba32 c = outFmt.pixel(x, y);
+            p[0] = c.r; p[1] = c.g; p[2] = c.b; p[3] = c.a;
+        }
+    }
+}
+
+template <class out_pixel_fmt>
+void
+aggFloatPainter<out_pixel_fmt>::quantizeRows(unsigned y1, unsigned y2)
+{
+    unsigned width = buffer.width();
+    std::vector<out_color> row(width);
+    for (unsigned y = y1; y < y2; ++y) {
+        const float* p = reinterpret_cast<const float*>(accumBuffer.row_ptr(y));
+        const float* dither = OrderedDither[y & 3];
+        for (unsigned x = 0; x < width; ++x, p += 4)
+            row[x] = out_color(quantize<quant_color>(p, dither[x & 3]));
+        outFmt.copy_color_hspan(0, static_cast<int>(y), width, row.data());
+    }
+}
+
+template <class out_pixel_fmt>
+void
+aggFloatPainter<out_pixel_fmt>::flush()
+{
+    // Bands of rows are quantized in parallel
+    unsigned height = buffer.height();
+    unsigned bands = std::min(std::thread::hardware_concurrency(), height / QuantizeBandRows);
+    bands = std::max(bands, 1u);
+    
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < bands; ++i)
+        workers.emplace_back(&aggFloatPainter::quantizeRows, this,
+                             height * i / bands, height * (i + 1) / bands);
+    quantizeRows(0, height / bands);
+    for (auto&& worker: workers)
+        worker.join();
+}
+
+template <class out_pixel_fmt>
+void
+aggFloatPainter<out_pixel_fmt>::draw(const aggCanvas& src, int x, int y)
+{
+    out_pixel_fmt srcPixFmt(src.m->buffer);
+    agg::copy_rect(srcPixFmt, pixFmt, nullptr, x, y);
+}
+
 template <class pixel_fmt>
 bool
 aggPixelPainter<pixel_fmt>::colorCount256()
 {
-    return pixelSet.size() < PNG8Limit;
+    return fitsPalette(buffer, pixel_fmt::pix_width);
 }
 
 template <class pixel_fmt>
@@ -272,6 +428,10 @@ template<>
 void aggPixelPainter<customff_pixel_fmt>::comp_op(agg::comp_op_e blend)
 { pixFmt.comp_op(static_cast<unsigned>(blend)); }
 
+template<>
+void aggPixelPainter<float_pixel_fmt>::comp_op(agg::comp_op_e blend)
+{ pixFmt.comp_op(static_cast<unsigned>(blend)); }
+
 template <class pixel_fmt>
 void
 aggPixelPainter<pixel_fmt>::fill(RGBA8 bk)
@@ -288,15 +448,6 @@ aggPixelPainter<pixel_fmt>::draw(RGBA8 col, agg::filling_rule_e fr, agg::comp_op
 {
     using color_type = typename pixel_fmt::color_type;
     using Converter_type = agg::ColorConverter<RGBA8, color_type>;
-    if (pixelSet.size() < PNG8Limit) {
-        agg::int64u pixel = 
-            static_cast<agg::int64u>(col.r) << 48 |
-            static_cast<agg::int64u>(col.g) << 32 |
-            static_cast<agg::int64u>(col.b) << 16 |
-            static_cast<agg::int64u>(col.a);
-        pixelSet.insert(pixel);
-    }
-    
     color_type c = Converter_type::f(col);
     comp_op(blend);
     rendSolid.color(c.premultiply());
@@ -305,6 +456,17 @@ aggPixelPainter<pixel_fmt>::draw(RGBA8 col, agg::filling_rule_e fr, agg::comp_op
     rasterizer.reset();
 }
 
+template <class pixel_fmt>
+void
+aggPixelPainter<pixel_fmt>::drawEllipse(RGBA8 col, agg::comp_op_e blend)
+{
+    using color_type = typename pixel_fmt::color_type;
+    using Converter_type = agg::ColorConverter<RGBA8, color_type>;
+    color_type c = Converter_type::f(col);
+    comp_op(blend);
+    analyticEllipse.render(rendBase, c.premultiply());
+}
+
 template <class  pixel_fmt>
 void
 aggPixelPainter<pixel_fmt>::copy(void* data, unsigned width, unsigned height,
@@ -372,21 +534,33 @@ aggPixelPainter<pixel_fmt>::draw(const aggCanvas& src, int x, int y)
     agg::copy_rect(srcPixFmt, pixFmt, nullptr, x, y);
 }
 
-aggCanvas::aggCanvas(PixelFormat pixfmt) : Canvas(0, 0) { 
-    switch (pixfmt) {
-        case Gray8_Blend:   m = std::make_unique<aggPixelPainter<gray_pixel_fmt>>(this); break;
-        case RGBA8_Blend:   m = std::make_unique<aggPixelPainter<color32_pixel_fmt>>(this); break;
-        case RGB8_Blend:    m = std::make_unique<aggPixelPainter<color24_pixel_fmt>>(this); break;
-        case Gray16_Blend:  m = std::make_unique<aggPixelPainter<gray16_pixel_fmt>>(this); break;
-        case RGBA16_Blend:  m = std::make_unique<aggPixelPainter<color64_pixel_fmt>>(this); break;
-        case RGB16_Blend:   m = std::make_unique<aggPixelPainter<color48_pixel_fmt>>(this); break;
+namespace {
+    template <class pixel_fmt>
+    std::unique_ptr<aggCanvas::impl>
+    makePainter(aggCanvas* canvas, bool floatAccum)
+    {
+        if (floatAccum)
+            return std::make_unique<aggFloatPainter<pixel_fmt>>(canvas);
+        return std::make_unique<aggPixelPainter<pixel_fmt>>(canvas);
+    }
+}
+
+aggCanvas::aggCanvas(PixelFormat pixfmt) : Canvas(0, 0), mFormat(pixfmt) { 
+    bool floatAccum = (pixfmt & Has_Float_Accum) != 0;
+    switch (static_cast<PixelFormat>(pixfmt & ~Has_Float_Accum)) {
+        case Gray8_Blend:   m = makePainter<gray_pixel_fmt>(this, floatAccum); break;
+        case RGBA8_Blend:   m = makePainter<color32_pixel_fmt>(this, floatAccum); break;
+        case RGB8_Blend:    m = makePainter<color24_pixel_fmt>(this, floatAccum); break;
+        case Gray16_Blend:  m = makePainter<gray16_pixel_fmt>(this, floatAccum); break;
+        case RGBA16_Blend:  m = makePainter<color64_pixel_fmt>(this, floatAccum); break;
+        case RGB16_Blend:   m = makePainter<color48_pixel_fmt>(this, floatAccum); break;
         case FF_Blend:      m = std::make_unique<aggPixelPainter<ff_pixel_fmt>>(this); break;
         case FF24_Blend:    m = std::make_unique<aggPixelPainter<ff24_pixel_fmt>>(this); break;
         case AV_Blend:      m = std::make_unique<aggPixelPainter<av_pixel_fmt>>(this); break;
         case RGBA8_Custom_Blend:
-            m = std::make_unique<aggPixelPainter<custom32_pixel_fmt>>(this); break;
+            m = makePainter<custom32_pixel_fmt>(this, floatAccum); break;
         case RGBA16_Custom_Blend:
-            m = std::make_unique<aggPixelPainter<custom64_pixel_fmt>>(this); break;
+            m = makePainter<custom64_pixel_fmt>(this, floatAccum); break;
         case FF_Custom_Blend:
             m = std::make_unique<aggPixelPainter<customff_pixel_fmt>>(this); break;
         case AV_Custom_Blend:
@@ -404,7 +578,6 @@ aggCanvas::start(bool clear, const agg::rgba& bk, int width, int height)
 {
     Canvas::start(clear, bk, width, height);
     if (clear) {
-        m->pixelSet.clear();
         m->cropWidth = width;
         m->cropHeight = height;
         m->offsetX = (mWidth - width) / 2;
@@ -417,7 +590,10 @@ aggCanvas::start(bool clear, const agg::rgba& bk, int width, int height)
 
 void
 aggCanvas::end()
-{ Canvas::end(); }
+{
+    m->flush();
+    Canvas::end();
+}
 
 void
 aggCanvas::primitive(int shape, RGBA8 c, agg::trans_affine tr, agg::comp_op_e blend)
@@ -427,6 +603,10 @@ aggCanvas::primitive(int shape, RGBA8 c, agg::trans_affine tr, agg::comp_op_e bl
     
     switch (shape) {
         case primShape::circleType:
+            if (m->analyticEllipse.init(tr, 0.5 * polygonRadius(size))) {
+                m->drawEllipse(c, blend);
+                return;
+            }
             m->shapeEllipse.transformer(tr);
             m->unitEllipse.init(0.0, 0.0, 0.5, 0.5, int(size)+8);
             m->rasterizer.add_path(m->shapeEllipse);
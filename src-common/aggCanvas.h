@@ -47,6 +47,8 @@ class aggCanvas : public Canvas {
             AV_Blend = 6,
             Has_16bit_Color = 8,
             Has_Custom_Blend = 16,
+            Has_Float_Accum = 32,   // render into a float buffer and quantize
+                                    // to the pixel format at end()
             Gray16_Blend = Gray8_Blend | Has_16bit_Color, 
             RGBA16_Blend = RGBA8_Blend | Has_16bit_Color, 
             RGB16_Blend = RGB8_Blend | Has_16bit_Color,
@@ -56,6 +58,15 @@ class aggCanvas : public Canvas {
             AV_Custom_Blend = AV_Blend | Has_Custom_Blend
         };
         static const std::map<PixelFormat, int> BytesPerPixel;
+#ifdef _WIN32
+        using RGBAOrder = agg::order_bgra;
+        using RGBOrder  = agg::order_bgr;
+#else
+        using RGBAOrder = agg::order_rgba;
+        using RGBOrder  = agg::order_rgb;
+#endif
+            // channel order in the pixel buffer of the RGBA and RGB formats,
+            // 8 or 16 bits per channel
         void start(bool clear, const agg::rgba& bk, int width, int height) override;
         void end() override;
 
@@ -63,7 +74,8 @@ class aggCanvas : public Canvas {
         void path(RGBA8 c, agg::trans_affine tr, const AST::CommandInfo& attr) override;
         
         bool colorCount256();
-            // return whether the aggCanvas can fit in byte pixels
+            // return whether the image has few enough colors for a palette
+        PixelFormat pixelFormat() const { return mFormat; }
         
         static PixelFormat SuggestPixelFormat(CFDG* engine);
         
@@ -87,6 +99,9 @@ class aggCanvas : public Canvas {
 
         void draw(const aggCanvas& src, int x, int y);
     
+    private:
+        PixelFormat mFormat;
+
     //private:
     public:
         class impl;
@@ -358,7 +358,7 @@ namespace AST {
     // appropriate affine transforms to the SymmList. Avoid adding the identity
     // transform if it is already present in the SymmList.
     void
-    processSymmSpec(SymmList& syms, agg::trans_affine& tile, bool tiled,
+    processSymmSpec(SymmList& syms, const agg::trans_affine& tile, bool tiled,
                     std::vector<double>& data, const yy::location& where)
     {
         if (data.empty()) return;
@@ -1016,7 +1016,7 @@ namespace AST {
     
     std::vector<const ASTmodification*>
     getTransforms(const ASTexpression* e, SymmList& syms, RendererAST* r, 
-                  bool tiled, agg::trans_affine& tile)
+                  bool tiled, const agg::trans_affine& tile)
     {
         std::vector<const ASTmodification*> ret;
         syms.clear();
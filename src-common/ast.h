@@ -59,6 +59,7 @@ namespace AST {
     class ASTrepContainer;
     class ASTdefine;
     class ASTcompiledPath;
+    class ASTbytecode;
 
     using str_ptr      = std::unique_ptr<std::string>;
     using exp_ptr      = std::unique_ptr<ASTexpression>;
@@ -73,6 +74,7 @@ namespace AST {
     using cont_ptr     = std::unique_ptr<ASTrepContainer>;
     using def_ptr      = std::unique_ptr<ASTdefine>;
     using cpath_ptr    = std::unique_ptr<ASTcompiledPath>;
+    using code_ptr     = std::unique_ptr<ASTbytecode>;
     
     using ASTbody       = std::vector<rep_ptr>;
     using ASTexpArray   = std::vector<exp_ptr>;
@@ -217,11 +219,11 @@ namespace AST {
     void addUnique(SymmList& syms, agg::trans_affine& tr);
     void processDihedral(SymmList& syms, double order, double x, double y,
                          bool dihedral, double angle, const yy::location& where);
-    void processSymmSpec(SymmList& syms, agg::trans_affine& tile, bool tiled,
+    void processSymmSpec(SymmList& syms, const agg::trans_affine& tile, bool tiled,
                          std::vector<double>& data, const yy::location& where);
     std::vector<const ASTmodification*>
          getTransforms(const ASTexpression* e, SymmList& syms, 
-                       RendererAST* r, bool tiled, agg::trans_affine& tile);
+                       RendererAST* r, bool tiled, const agg::trans_affine& tile);
 }
 
 #endif // INCLUDE_AST_H
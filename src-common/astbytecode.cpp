@@ -0,0 +1,518 @@
+// astbytecode.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+#include "astbytecode.h"
+#include "astexpression.h"
+#include "rendererAST.h"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+namespace AST {
+
+    bool ASTbytecode::Lowering = true;
+
+    class ASTbytecode::Compiler {
+    // Emits the instructions for an expression tree. The result of each
+    // sub-expression is put in the registers at the top of the register
+    // stack when it starts, its temporaries are above that and are released
+    // when it is done. Anything that the tree walker would report as an error
+    // throws GiveUp, so the expression is left to the tree.
+    public:
+        struct GiveUp {};
+
+        explicit Compiler(ASTbytecode& code) : mCode(code) {}
+
+        int compile(const ASTexpression* e);
+            // returns the tuple size of e
+
+    private:
+        ASTbytecode&    mCode;
+        std::size_t     mTop = 0;
+
+        std::size_t reserve(int n);
+        void release(std::size_t top) { mTop = top; }
+        Instr& emit(Op op, std::size_t dst, int n = 1, std::size_t a = 0,
+                    std::size_t b = 0);
+        int call(const ASTexpression* e);
+        int compileOperator(const ASToperator* o);
+        int compileFunction(const ASTfunction* f);
+        int compileSelect(const ASTselect* s);
+    };
+
+    std::size_t
+    ASTbytecode::Compiler::reserve(int n)
+    {
+        if (n < 1 || n > MaxVectorSize)
+            throw GiveUp();
+        std::size_t dst = mTop;
+        mTop += static_cast<std::size_t>(n);
+        if (mTop > std::numeric_limits<std::uint16_t>::max())
+            throw GiveUp();
+        mCode.mRegisters = std::max(mCode.mRegisters, mTop);
+        return dst;
+    }
+
+    ASTbytecode::Instr&
+    ASTbytecode::Compiler::emit(Op op, std::size_t dst, int n, std::size_t a,
+                                std::size_t b)
+    {
+        if (b > std::numeric_limits<std::uint16_t>::max())
+            throw GiveUp();
+        Instr i;
+        i.op = op;
+        i.n = static_cast<std::uint16_t>(n);
+        i.dst = static_cast<std::uint16_t>(dst);
+        i.a = static_cast<std::uint16_t>(a);
+        i.b = static_cast<std::uint16_t>(b);
+        i.jump = 0;
+        mCode.mCode.push_back(i);
+        return mCode.mCode.back();
+    }
+
+    int
+    ASTbytecode::Compiler::call(const ASTexpression* e)
+    {
+        // Only for expressions that do not complain about being sized
+        int n = e->evaluate();
+        emit(Op::Call, reserve(n), n).node = e;
+        return n;
+    }
+
+    int
+    ASTbytecode::Compiler::compile(const ASTexpression* e)
+    {
+        if (auto r = dynamic_cast<const ASTreal*>(e)) {
+            emit(Op::Const, reserve(1)).value = r->value;
+            return 1;
+        }
+        if (auto v = dynamic_cast<const ASTvariable*>(e)) {
+            if (v->mType != NumericType)
+                throw GiveUp();
+            if (v->stackIndex == ASTvariable::IllegalStackIndex)
+                return call(v);
+            emit(Op::Load, reserve(v->count), v->count).stackIndex = v->stackIndex;
+            return v->count;
+        }
+        if (auto c = dynamic_cast<const ASTcons*>(e)) {
+            if ((static_cast<int>(c->mType) & (NumericType | FlagType)) == 0 ||
+                (static_cast<int>(c->mType) & (ModType | RuleType)) ||
+                c->children.empty())
+            {
+                throw GiveUp();
+            }
+            int count = 0;
+            for (auto&& child: c->children)
+                count += compile(child.get());
+            return count;
+        }
+        if (auto p = dynamic_cast<const ASTparen*>(e)) {
+            if (p->mType != NumericType)
+                throw GiveUp();
+            return compile(p->e.get());
+        }
+        if (auto o = dynamic_cast<const ASToperator*>(e))
+            return compileOperator(o);
+        if (auto f = dynamic_cast<const ASTfunction*>(e))
+            return compileFunction(f);
+        if (auto s = dynamic_cast<const ASTselect*>(e))
+            return compileSelect(s);
+        if (auto a = dynamic_cast<const ASTarray*>(e)) {
+            if (a->mType != NumericType)
+                throw GiveUp();
+            std::size_t dst = reserve(a->mLength);
+            std::size_t index = mTop;
+            if (compile(a->mArgs.get()) != 1)
+                throw GiveUp();
+            emit(Op::Array, dst, a->mLength, index).array = a;
+            release(dst + a->mLength);
+            return a->mLength;
+        }
+        if (auto u = dynamic_cast<const ASTuserFunction*>(e)) {
+            if (u->mType != NumericType || !u->definition)
+                throw GiveUp();
+            return call(u);
+        }
+        throw GiveUp();
+    }
+
+    int
+    ASTbytecode::Compiler::compileOperator(const ASToperator* o)
+    {
+        if (o->mType != NumericType || !o->left)
+            throw GiveUp();
+
+        if (!o->right) {
+            // The tree walker only returns the first element of unary
+            // operators, so vectors stay with it
+            if (o->tupleSize != 1)
+                return call(o);
+            switch (o->op) {
+                case 'P':
+                    if (compile(o->left.get()) != 1)
+                        throw GiveUp();
+                    return 1;
+                case 'N':
+                case '!': {
+                    std::size_t dst = reserve(1);
+                    std::size_t l = mTop;
+                    if (compile(o->left.get()) != 1)
+                        throw GiveUp();
+                    emit(o->op == 'N' ? Op::Neg : Op::Not, dst, 1, l);
+                    release(dst + 1);
+                    return 1;
+                }
+                default:
+                    throw GiveUp();
+            }
+        }
+
+        if (o->op == '&' || o->op == '|') {
+            // Short-circuit: the right operand replaces the left one in the
+            // result register only if it is evaluated
+            std::size_t dst = mTop;
+            if (compile(o->left.get()) != 1)
+                throw GiveUp();
+            std::size_t branch = mCode.mCode.size();
+            emit(o->op == '&' ? Op::And : Op::Or, dst, 1, dst);
+            release(dst);
+            if (compile(o->right.get()) != 1)
+                throw GiveUp();
+            mCode.mCode[branch].jump = mCode.mCode.size();
+            return 1;
+        }
+
+        int n = o->tupleSize;
+        std::size_t dst = reserve(n);
+        std::size_t l = mTop;
+        int ln = compile(o->left.get());
+        std::size_t r = mTop;
+        int rn = compile(o->right.get());
+
+        Op op;
+        switch (o->op) {
+            case '+': op = Op::Add; break;
+            case '-': op = Op::Sub; break;
+            case '_': op = Op::Dim; break;
+            case '*': op = ln == rn ? Op::Mul : ln == 1 ? Op::MulL : Op::MulR; break;
+            case '/': op = ln == rn ? Op::Div : ln == 1 ? Op::DivL : Op::DivR; break;
+            case '<': op = Op::Lt; break;
+            case 'L': op = Op::Le; break;
+            case '>': op = Op::Gt; break;
+            case 'G': op = Op::Ge; break;
+            case '=': op = Op::Eq; break;
+            case 'n': op = Op::Ne; break;
+            case 'X': op = Op::Xor; break;
+            case '^': op = o->isNatural ? Op::PowNatural : Op::Pow; break;
+            default:
+                throw GiveUp();
+        }
+        // The element-wise operators read n elements from each operand
+        if (op == Op::Add || op == Op::Sub || op == Op::Dim ||
+            op == Op::Eq || op == Op::Ne || op == Op::Mul || op == Op::Div)
+        {
+            if (ln < n || rn < n)
+                throw GiveUp();
+        } else if ((op == Op::MulL || op == Op::DivL) ? rn < n :
+                   (op == Op::MulR || op == Op::DivR) ? ln < n : n != 1)
+        {
+            throw GiveUp();
+        }
+
+        emit(op, dst, n, l, r);
+        release(dst + static_cast<std::size_t>(n));
+        return n;
+    }
+
+    int
+    ASTbytecode::Compiler::compileFunction(const ASTfunction* f)
+    {
+        if (f->mType != NumericType || !f->arguments)
+            throw GiveUp();
+
+        switch (f->functype) {
+            case ASTfunction::Min:
+            case ASTfunction::Max: {
+                std::size_t dst = reserve(1);
+                std::size_t args = mTop;
+                int count = 0;
+                for (auto&& kid: *f->arguments) {
+                    if (compile(&kid) != 1)
+                        throw GiveUp();
+                    ++count;
+                }
+                emit(f->functype == ASTfunction::Min ? Op::Min : Op::Max,
+                     dst, count, args);
+                release(dst + 1);
+                return 1;
+            }
+            case ASTfunction::Dot:
+            case ASTfunction::Cross:
+            case ASTfunction::Vec:
+            case ASTfunction::Hsb2Rgb:
+            case ASTfunction::Rgb2Hsb:
+            case ASTfunction::RandDiscrete:
+            case ASTfunction::NotAFunction:
+                return call(f);
+            default:
+                break;
+        }
+
+        std::size_t dst = reserve(1);
+        std::size_t args = mTop;
+        int count = compile(f->arguments.get());
+        if (count > 2)
+            throw GiveUp();
+        if (f->scalarFunc)
+            emit(Op::Scalar, dst, count, args).scalar = f->scalarFunc;
+        else
+            emit(Op::Func, dst, count, args).func = f;
+        release(dst + 1);
+        return 1;
+    }
+
+    int
+    ASTbytecode::Compiler::compileSelect(const ASTselect* s)
+    {
+        if (s->mType != NumericType || s->arguments.empty())
+            throw GiveUp();
+        if (s->indexCache != ASTselect::NotCached)
+            return compile(s->arguments[s->indexCache].get());
+
+        // Every branch puts its result in the same registers
+        std::size_t dst = mTop;
+        if (compile(s->selector.get()) != 1)
+            throw GiveUp();
+        std::size_t table = mCode.mJumpTable.size();
+        emit(Op::Select, dst, 1, dst, table).select = s;
+        mCode.mJumpTable.resize(table + s->arguments.size());
+
+        std::vector<std::size_t> exits;
+        for (std::size_t i = 0; i < s->arguments.size(); ++i) {
+            release(dst);
+            mCode.mJumpTable[table + i] = mCode.mCode.size();
+            if (compile(s->arguments[i].get()) != s->tupleSize)
+                throw GiveUp();
+            exits.push_back(mCode.mCode.size());
+            emit(Op::Jump, dst);
+        }
+        for (auto exit: exits)
+            mCode.mCode[exit].jump = mCode.mCode.size();
+        return s->tupleSize;
+    }
+
+    std::unique_ptr<ASTbytecode>
+    ASTbytecode::Lower(const ASTexpression* e)
+    {
+        if (!Lowering || !e || e->mType != NumericType)
+            return nullptr;
+
+        std::unique_ptr<ASTbytecode> code(new ASTbytecode);
+        try {
+            Compiler c(*code);
+            code->mSize = c.compile(e);
+        } catch (Compiler::GiveUp&) {
+            return nullptr;
+        }
+
+        // A lone call or constant is no faster than the tree
+        if (code->mCode.size() == 1 && (code->mCode.front().op == Op::Call ||
+                                        code->mCode.front().op == Op::Const))
+            return nullptr;
+
+        code->mCode.shrink_to_fit();
+        return code;
+    }
+
+    int
+    ASTbytecode::run(double* res, int length, RendererAST* rti) const
+    {
+        if (length < mSize)
+            return -1;
+
+        std::array<double, LocalRegisters> local;
+        std::vector<double> heap;
+        double* regs = local.data();
+        if (mRegisters > LocalRegisters) {
+            heap.resize(mRegisters);
+            regs = heap.data();
+        }
+
+        if (!exec(regs, rti))
+            return -1;
+        std::copy_n(regs, mSize, res);
+        return mSize;
+    }
+
+    bool
+    ASTbytecode::exec(double* regs, RendererAST* rti) const
+    {
+        const Instr* code = mCode.data();
+        const Instr* end = code + mCode.size();
+        for (const Instr* i = code; i != end; ++i) {
+            double* d = regs + i->dst;
+            const double* l = regs + i->a;
+            const double* r = regs + i->b;
+            int n = i->n;
+            switch (i->op) {
+                case Op::Const:
+                    *d = i->value;
+                    break;
+                case Op::Load: {
+                    const StackType* item = rti->stackItem(i->stackIndex);
+                    for (int k = 0; k < n; ++k)
+                        d[k] = item[k].number;
+                    break;
+                }
+                case Op::Neg:
+                    *d = -*l;
+                    break;
+                case Op::Not:
+                    *d = (*l == 0.0) ? 1.0 : 0.0;
+                    break;
+                case Op::Add:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[k] + r[k];
+                    break;
+                case Op::Sub:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[k] - r[k];
+                    break;
+                case Op::Dim:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = ((l[k] - r[k]) > 0.0) ? (l[k] - r[k]) : 0.0;
+                    break;
+                case Op::Mul:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[k] * r[k];
+                    break;
+                case Op::MulL:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[0] * r[k];
+                    break;
+                case Op::MulR:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[k] * r[0];
+                    break;
+                case Op::Div:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[k] / r[k];
+                    break;
+                case Op::DivL:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[0] / r[k];
+                    break;
+                case Op::DivR:
+                    for (int k = 0; k < n; ++k)
+                        d[k] = l[k] / r[0];
+                    break;
+                case Op::Lt:
+                    *d = (*l < *r) ? 1.0 : 0.0;
+                    break;
+                case Op::Le:
+                    *d = (*l <= *r) ? 1.0 : 0.0;
+                    break;
+                case Op::Gt:
+                    *d = (*l > *r) ? 1.0 : 0.0;
+                    break;
+                case Op::Ge:
+                    *d = (*l >= *r) ? 1.0 : 0.0;
+                    break;
+                case Op::Eq:
+                    *d = std::equal(l, l + n, r) ? 1.0 : 0.0;
+                    break;
+                case Op::Ne:
+                    *d = std::equal(l, l + n, r) ? 0.0 : 1.0;
+                    break;
+                case Op::Xor:
+                    *d = ((*l != 0.0 && *r == 0.0) || (*l == 0.0 && *r != 0.0)) ? 1.0 : 0.0;
+                    break;
+                case Op::Pow:
+                    *d = pow(*l, *r);
+                    break;
+                case Op::PowNatural: {
+                    double p = pow(*l, *r);
+                    if (p < MaxNatural) {
+                        uint64_t ip = 1;
+                        auto il = static_cast<uint64_t>(*l);
+                        auto ir = static_cast<uint64_t>(*r);
+                        while (ir) {
+                            if (ir & 1) ip *= il;
+                            il *= il;
+                            ir >>= 1;
+                        }
+                        p = static_cast<double>(ip);
+                    }
+                    *d = p;
+                    break;
+                }
+                case Op::And:
+                    if (*l == 0.0) {
+                        *d = 0.0;
+                        i = code + i->jump - 1;
+                    }
+                    break;
+                case Op::Or:
+                    if (*l != 0.0)
+                        i = code + i->jump - 1;
+                    break;
+                case Op::Jump:
+                    i = code + i->jump - 1;
+                    break;
+                case Op::Select:
+                    i = code + mJumpTable[i->b + i->select->getIndex(*l)] - 1;
+                    break;
+                case Op::Scalar:
+                    *d = i->scalar(l);
+                    break;
+                case Op::Func:
+                    i->func->evaluateScalar(d, l, n, rti);
+                    break;
+                case Op::Min:
+                case Op::Max: {
+                    // same comparisons as the tree walker, for NaNs
+                    bool isMin = i->op == Op::Min;
+                    double m = l[0];
+                    for (int k = 1; k < n; ++k) {
+                        bool leftMin = m < l[k];
+                        m = ((isMin && leftMin) || (!isMin && !leftMin)) ? m : l[k];
+                    }
+                    *d = m;
+                    break;
+                }
+                case Op::Array:
+                    if (!i->array->fetch(*l, d, rti))
+                        return false;
+                    break;
+                case Op::Call:
+                    if (i->node->evaluate(d, n, rti) < 0)
+                        return false;
+                    break;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,89 @@
+// astbytecode.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// A numeric expression lowered to a flat list of instructions over a file of
+// double registers. Operators, built-in scalar functions, stack variables,
+// arrays and select() are run by the interpreter loop, anything else (user
+// functions, vector functions) is handed back to the expression tree. The
+// result is the same as ASTexpression::evaluate(), including the order that
+// random numbers are drawn in.
+
+#ifndef INCLUDE_ASTBYTECODE_H
+#define INCLUDE_ASTBYTECODE_H
+
+#include "ast.h"
+#include <cstdint>
+#include <vector>
+
+namespace AST {
+
+    class ASTfunction;
+    class ASTselect;
+    class ASTarray;
+
+    class ASTbytecode {
+    public:
+        static bool Lowering;
+            // clear to keep every expression on the tree walker
+        static std::unique_ptr<ASTbytecode> Lower(const ASTexpression* e);
+            // returns nullptr if e is not numeric or if the bytecode would
+            // do no better than the tree
+        int run(double* res, int length, RendererAST* rti) const;
+
+    private:
+        enum class Op : std::uint8_t {
+            Const, Load, Neg, Not, Add, Sub, Dim, Mul, MulL, MulR,
+            Div, DivL, DivR, Lt, Le, Gt, Ge, Eq, Ne, Xor, Pow, PowNatural,
+            And, Or, Jump, Select, Scalar, Func, Min, Max, Array, Call
+        };
+        struct Instr {
+            Op              op;
+            std::uint16_t   n;      // tuple size
+            std::uint16_t   dst;    // first result register
+            std::uint16_t   a;      // first register of each operand
+            std::uint16_t   b;      // or jump table start for Select
+            union {
+                double                  value;
+                int                     stackIndex;
+                std::size_t             jump;   // instruction index
+                const ASTexpression*    node;
+                const ASTfunction*      func;
+                double (*scalar)(const double*);
+                const ASTarray*         array;
+                const ASTselect*        select;
+            };
+        };
+        enum consts_t : std::size_t { LocalRegisters = 32 };
+
+        std::vector<Instr>          mCode;
+        std::vector<std::size_t>    mJumpTable;     // select() branches
+        std::size_t                 mRegisters = 0;
+        int                         mSize = 0;      // result tuple size
+
+        class Compiler;
+        bool exec(double* regs, RendererAST* rti) const;
+    };
+}
+
+#endif // INCLUDE_ASTBYTECODE_H
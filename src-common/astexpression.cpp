@@ -32,6 +32,8 @@
 #include <cassert>
 #include <algorithm>
 #include <array>
+#include <cstdint>
+#include <cstring>
 
 using std::floor;
 
@@ -196,6 +198,129 @@ namespace AST {
     }
     
     bool ASTfunction::RandStaticIsConst = true;
+    bool ASTfunction::FastMath = false;
+    
+    namespace {
+        const double DegToRad = 0.0174532925199;
+        const double RadToDeg = 57.29577951308;
+        const std::uint64_t NaturalMask = 0xfffffffffffffull;
+        
+        std::uint64_t nat(double v) { return static_cast<std::uint64_t>(v); }
+        
+        double cosDeg(const double* a)   { return cos(a[0] * DegToRad); }
+        double sinDeg(const double* a)   { return sin(a[0] * DegToRad); }
+        double tanDeg(const double* a)   { return tan(a[0] * DegToRad); }
+        double cotDeg(const double* a)   { return 1.0 / tan(a[0] * DegToRad); }
+        double acosDeg(const double* a)  { return acos(a[0]) * RadToDeg; }
+        double asinDeg(const double* a)  { return asin(a[0]) * RadToDeg; }
+        double atanDeg(const double* a)  { return atan(a[0]) * RadToDeg; }
+        double acotDeg(const double* a)  { return atan(1.0 / a[0]) * RadToDeg; }
+        double atan2Deg(const double* a) { return atan2(a[0], a[1]) * RadToDeg; }
+        double coshF(const double* a)    { return cosh(a[0]); }
+        double sinhF(const double* a)    { return sinh(a[0]); }
+        double tanhF(const double* a)    { return tanh(a[0]); }
+        double acoshF(const double* a)   { return acosh(a[0]); }
+        double asinhF(const double* a)   { return asinh(a[0]); }
+        double atanhF(const double* a)   { return atanh(a[0]); }
+        double logF(const double* a)     { return log(a[0]); }
+        double log10F(const double* a)   { return log10(a[0]); }
+        double sqrtF(const double* a)    { return sqrt(a[0]); }
+        double expF(const double* a)     { return exp(a[0]); }
+        double abs1(const double* a)     { return fabs(a[0]); }
+        double abs2(const double* a)     { return fabs(a[0] - a[1]); }
+        double floorF(const double* a)   { return floor(a[0]); }
+        double ceilF(const double* a)    { return ceil(a[0]); }
+        double sgF(const double* a)      { return a[0] == 0.0 ? 0.0 : 1.0; }
+        double fmodF(const double* a)    { return fmod(a[0], a[1]); }
+        double modNat(const double* a)
+        { return static_cast<double>(nat(a[0]) % nat(a[1])); }
+        double dividesF(const double* a)
+        { return (nat(a[0]) % nat(a[1]) == 0ULL) ? 1.0 : 0.0; }
+        double divF(const double* a)
+        { return static_cast<double>(nat(a[0]) / nat(a[1])); }
+        double bitNot(const double* a)
+        { return static_cast<double>(~nat(a[0]) & NaturalMask); }
+        double bitOr(const double* a)
+        { return static_cast<double>((nat(a[0]) | nat(a[1])) & NaturalMask); }
+        double bitAnd(const double* a)
+        { return static_cast<double>((nat(a[0]) & nat(a[1])) & NaturalMask); }
+        double bitXor(const double* a)
+        { return static_cast<double>((nat(a[0]) ^ nat(a[1])) & NaturalMask); }
+        double bitLeft(const double* a)
+        { return static_cast<double>((nat(a[0]) << nat(a[1])) & NaturalMask); }
+        double bitRight(const double* a)
+        { return static_cast<double>((nat(a[0]) >> nat(a[1])) & NaturalMask); }
+        
+        // FastMath versions. Angles are reduced in degrees, which is exact,
+        // to within 45 degrees of a multiple of 90 and the minimax
+        // polynomials from Cephes are used from there. Huge and non-finite
+        // arguments go to the C library.
+        
+        const double Pi180 = 0.017453292519943295769;
+        
+        bool sinCosDeg(double x, double& s, double& c)
+        {
+            if (!(fabs(x) < 1.0e12))
+                return false;
+            double q = floor(x * (1.0 / 90.0) + 0.5);
+            double r = (x - q * 90.0) * Pi180;
+            double z = r * r;
+            double sr = r + r * z * (((((1.58962301576546568060e-10 * z
+                         - 2.50507477628578072866e-8) * z + 2.75573136213857245213e-6) * z
+                         - 1.98412698295895385996e-4) * z + 8.33333333332211858878e-3) * z
+                         - 1.66666666666666307295e-1);
+            double cr = 1.0 - 0.5 * z + z * z * (((((-1.13585365213876817300e-11 * z
+                         + 2.08757008419747316778e-9) * z - 2.75573141792967388112e-7) * z
+                         + 2.48015872888517045348e-5) * z - 1.38888888888730564116e-3) * z
+                         + 4.16666666666665929218e-2);
+            switch (static_cast<long long>(q) & 3) {
+                case 0: s =  sr; c =  cr; break;
+                case 1: s =  cr; c = -sr; break;
+                case 2: s = -sr; c = -cr; break;
+                default: s = -cr; c =  sr; break;
+            }
+            return true;
+        }
+        
+        double fastCos(const double* a)
+        {
+            double s, c;
+            return sinCosDeg(a[0], s, c) ? c : cosDeg(a);
+        }
+        double fastSin(const double* a)
+        {
+            double s, c;
+            return sinCosDeg(a[0], s, c) ? s : sinDeg(a);
+        }
+        double fastTan(const double* a)
+        {
+            double s, c;
+            return sinCosDeg(a[0], s, c) ? s / c : tanDeg(a);
+        }
+        double fastCot(const double* a)
+        {
+            double s, c;
+            return sinCosDeg(a[0], s, c) ? c / s : cotDeg(a);
+        }
+        double fastExp(const double* a)
+        {
+            double x = a[0];
+            if (!(x > -708.0 && x < 709.0))
+                return exp(x);
+            // exp(x) = 2^k * exp(r), |r| <= ln(2)/2
+            double k = floor(x * 1.4426950408889634074 + 0.5);
+            double r = (x - k * 6.93145751953125e-1) - k * 1.42860682030941723212e-6;
+            double p = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 +
+                       r * (1.0 / 120 + r * (1.0 / 720 + r * (1.0 / 5040 +
+                       r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800 +
+                       r * (1.0 / 39916800 + r * (1.0 / 479001600 +
+                       r * (1.0 / 6227020800)))))))))))));
+            std::uint64_t bits = static_cast<std::uint64_t>(static_cast<std::int64_t>(k) + 1023) << 52;
+            double scale;
+            std::memcpy(&scale, &bits, sizeof scale);
+            return p * scale;
+        }
+    }
     
     ASTfunction::ASTfunction(const std::string& func, exp_ptr args, Rand64& r,
                              const yy::location& nameLoc, const yy::location& argsLoc,
@@ -661,6 +786,21 @@ namespace AST {
         }
     }
     
+    int
+    ASTexpression::evaluateLowered(double* res, int length, RendererAST* rti) const
+    {
+        if (mCode && res && rti)
+            return mCode->run(res, length, rti);
+        return evaluate(res, length, rti);
+    }
+    
+    void
+    ASTexpression::lower()
+    {
+        if (mType == NumericType && !isConstant)
+            mCode = ASTbytecode::Lower(this);
+    }
+    
     ASTexpression*
     ASTexpression::Append(ASTexpression* l, ASTexpression* r)
     {
@@ -793,7 +933,7 @@ namespace AST {
             throw CfdgError(where, "Stopping");
         
         StackSetup saveIt(this, rti);
-        if (definition->mExpression->evaluate(res, length, rti) != definition->mTuplesize)
+        if (definition->mExpression->evaluateLowered(res, length, rti) != definition->mTuplesize)
             CfdgError::Error(where, "Error evaluating function");
         return definition->mTuplesize;
     }   // saveIt dtor cleans up stack
@@ -975,9 +1115,61 @@ namespace AST {
         return res;
     }
     
+    ASTfunction::ScalarFunc
+    ASTfunction::GetScalarFunc(FuncType t, int argcount, bool naturalArgs)
+    {
+        switch (t) {
+            case Cos:       return FastMath ? fastCos : cosDeg;
+            case Sin:       return FastMath ? fastSin : sinDeg;
+            case Tan:       return FastMath ? fastTan : tanDeg;
+            case Cot:       return FastMath ? fastCot : cotDeg;
+            case Acos:      return acosDeg;
+            case Asin:      return asinDeg;
+            case Atan:      return atanDeg;
+            case Acot:      return acotDeg;
+            case Cosh:      return coshF;
+            case Sinh:      return sinhF;
+            case Tanh:      return tanhF;
+            case Acosh:     return acoshF;
+            case Asinh:     return asinhF;
+            case Atanh:     return atanhF;
+            case Log:       return logF;
+            case Log10:     return log10F;
+            case Sqrt:      return sqrtF;
+            case Exp:       return FastMath ? fastExp : expF;
+            case Abs:       return argcount == 1 ? abs1 : argcount == 2 ? abs2 : nullptr;
+            case Floor:     return floorF;
+            case Ceiling:   return ceilF;
+            case Sg:        return sgF;
+            case BitNot:    return bitNot;
+            case BitOr:     return bitOr;
+            case BitAnd:    return bitAnd;
+            case BitXOR:    return bitXor;
+            case BitLeft:   return bitLeft;
+            case BitRight:  return bitRight;
+            case Atan2:     return atan2Deg;
+            case Mod:       return naturalArgs ? modNat : fmodF;
+            case Divides:   return dividesF;
+            case Div:       return divF;
+            default:        return nullptr;
+        }
+    }
+    
     int 
     ASTfunction::evaluate(double* res, int length, RendererAST* rti) const
     {
+        if (scalarFunc) {
+            if (!res)
+                return 1;
+            if (length < 1)
+                return -1;
+            std::array<double, 2> a;
+            if (arguments->evaluate(a.data(), 2, rti) < 0)
+                return 1;
+            *res = scalarFunc(a.data());
+            return 1;
+        }
+        
         if (mType != NumericType) {
             CfdgError::Error(where, "Non-numeric expression in a numeric context");
             return -1;
@@ -1066,30 +1258,36 @@ namespace AST {
         // But check it anyway to make valgrind happy
         if (count < 0) return 1;
 
+        return evaluateScalar(res, a.data(), count, rti);
+    }
+    
+    int
+    ASTfunction::evaluateScalar(double* res, const double* a, int count, RendererAST* rti) const
+    {
         switch (functype) {
             case  Cos:  
-                *res = cos(a[0] * 0.0174532925199);
+                *res = cos(a[0] * DegToRad);
                 break;
             case  Sin:  
-                *res = sin(a[0] * 0.0174532925199);
+                *res = sin(a[0] * DegToRad);
                 break;
             case  Tan:  
-                *res = tan(a[0] * 0.0174532925199);
+                *res = tan(a[0] * DegToRad);
                 break;
             case  Cot:  
-                *res = 1.0 / tan(a[0] * 0.0174532925199);
+                *res = 1.0 / tan(a[0] * DegToRad);
                 break;
             case  Acos:  
-                *res = acos(a[0]) * 57.29577951308;
+                *res = acos(a[0]) * RadToDeg;
                 break;
             case  Asin:  
-                *res = asin(a[0]) * 57.29577951308;
+                *res = asin(a[0]) * RadToDeg;
                 break;
             case  Atan:  
-                *res = atan(a[0]) * 57.29577951308;
+                *res = atan(a[0]) * RadToDeg;
                 break;
             case  Acot:  
-                *res = atan(1.0 / a[0]) * 57.29577951308;
+                *res = atan(1.0 / a[0]) * RadToDeg;
                 break;
             case  Cosh:  
                 *res = cosh(a[0]);
@@ -1161,7 +1359,7 @@ namespace AST {
                 *res = static_cast<double>((static_cast<uint64_t>(a[0]) >> static_cast<uint64_t>(a[1])) & 0xfffffffffffffull);
                 break;
             case Atan2: 
-                *res = atan2(a[0], a[1]) * 57.29577951308;
+                *res = atan2(a[0], a[1]) * RadToDeg;
                 break;
             case Mod: 
                 if (arguments->isNatural)
@@ -1354,21 +1552,29 @@ namespace AST {
                 CfdgError::Error(mArgs->where, "Cannot evaluate vector index");
                 return -1;
             }
-            int index = static_cast<int>(index_d);
-            if ((mLength - 1) * mStride + index >= mCount || index < 0) {
-                CfdgError::Error(where, "Vector index exceeds bounds");
+            if (!fetch(index_d, res, rti))
                 return -1;
-            }
-            
-            const double* source = mData.empty() ? &(rti->stackItem(mStackIndex)->number) : mData.data();
-            
-            for (int i = 0; i < mLength; ++i)
-                res[i] = source[i * mStride + index];
         }
         
         return mLength;
     }
     
+    bool
+    ASTarray::fetch(double index_d, double* res, RendererAST* rti) const
+    {
+        int index = static_cast<int>(index_d);
+        if ((mLength - 1) * mStride + index >= mCount || index < 0) {
+            CfdgError::Error(where, "Vector index exceeds bounds");
+            return false;
+        }
+        
+        const double* source = mData.empty() ? &(rti->stackItem(mStackIndex)->number) : mData.data();
+        
+        for (int i = 0; i < mLength; ++i)
+            res[i] = source[i * mStride + index];
+        return true;
+    }
+    
     void
     ASTselect::evaluate(Modification& m, bool shapeDest, RendererAST* rti) const
     {
@@ -1507,7 +1713,7 @@ namespace AST {
                         CfdgError::Error(where, "Blend adjustments require flag arguments");
                         return;
                     }
-                    argcount = args->evaluate(modArgs.data(), 6, rti);
+                    argcount = args->evaluateLowered(modArgs.data(), 6, rti);
                     break;
                 case FlagType:
                     if (modType != ASTmodTerm::blend) {
@@ -2000,6 +2206,12 @@ namespace AST {
     {
         Simplify(arguments, b);
         
+        if (mType == NumericType && arguments && arguments->mType == NumericType) {
+            int argcount = arguments->evaluate();
+            if (argcount == 1 || argcount == 2)
+                scalarFunc = GetScalarFunc(functype, argcount, arguments->isNatural);
+        }
+        
         if (isConstant) {
             std::array<double, AST::MaxVectorSize> result;
             int len = evaluate(result.data(), (int)result.size());
@@ -2032,10 +2244,13 @@ namespace AST {
     {
         if (arguments) {
             if (auto carg = dynamic_cast<ASTcons*>(arguments.get())) {
-                for (auto& child: carg->children)
+                for (auto& child: carg->children) {
                     Simplify(child, b);
+                    child->lower();
+                }
             } else {
                 Simplify(arguments, b);
+                arguments->lower();
             }
         }
         if (argSource == StackArgs) {
@@ -2104,10 +2319,13 @@ namespace AST {
                 // Can't use ASTcons::simplify() because it will collapse the
                 // ASTcons if it only has one child and that will break the
                 // function arguments.
-                for (auto& child: carg->children)
+                for (auto& child: carg->children) {
                     Simplify(child, b);
+                    child->lower();
+                }
             } else {
                 Simplify(arguments, b);
+                arguments->lower();
             }
         }
         return nullptr;
@@ -2282,6 +2500,8 @@ namespace AST {
             if (keepThisOne) {
                 assert(mod->modType != ASTmodTerm::param);
                 Simplify(mod->args, b);
+                if (mod->args)
+                    mod->args->lower();
                 modExp.push_back(std::move(mod));
             }
         }
@@ -2436,6 +2656,7 @@ namespace AST {
                     case Frame:
                         if (arguments)
                             CfdgError::Error(argsLoc, "ftime()/frame() functions takes no arguments", b);
+                        b->readsFrameTime();
                         isConstant = false;
                         arguments = std::make_unique<ASTreal>(1.0, argsLoc);
                         break;
@@ -2613,6 +2834,8 @@ namespace AST {
         
         switch (ph) {
             case CompilePhase::TypeCheck: {
+                if (argSource != ShapeArgs && argSource != StackArgs)
+                    b->referenceShape(shapeType);
                 switch (argSource) {
                     case ShapeArgs:
                         if (!arguments) {
@@ -2648,6 +2871,8 @@ namespace AST {
                         if (bound.mStackIndex != -1) {
                             mStackIndex = bound.mStackIndex -
                                 (isGlobal ? 0 : b->mLocalStackDepth);
+                            if (isGlobal)
+                                b->usesGlobal(bound.mStackIndex);
                             isConstant = false;
                             mLocality = bound.mLocality;
                         }
@@ -2846,6 +3071,8 @@ namespace AST {
                     }
                     
                     stackIndex = bound.mStackIndex - (isGlobal ? 0 : b->mLocalStackDepth);
+                    if (isGlobal)
+                        b->usesGlobal(bound.mStackIndex);
                 }
                 break;
             }
@@ -2880,6 +3107,7 @@ namespace AST {
                     Compile(arguments, ph, b);
                     
                     definition = def;
+                    b->usesDefinition(def);
                     ASTparameter::CheckType(&(def->mParameters), arguments.get(), where, false, b);
                     isConstant = false;
                     isNatural = def->isNatural;
@@ -3301,6 +3529,8 @@ namespace AST {
                 isNatural = bound.isNatural;
                 mStackIndex = bound.mStackIndex -
                     (isGlobal ? 0 : b->mLocalStackDepth);
+                if (isGlobal)
+                    b->usesGlobal(bound.mStackIndex);
                 mCount = bound.mTuplesize;
                 isParameter = bound.isParameter;
                 mLocality = bound.mLocality;
@@ -3592,7 +3822,12 @@ namespace AST {
 
         double select = 0.0;
         selector->evaluate(&select, 1, rti);
-
+        return getIndex(select);
+    }
+    
+    std::size_t
+    ASTselect::getIndex(double select) const
+    {
         if (ifSelect)
             return (select != 0.0) ? 0 : 1;
         
@@ -27,6 +27,7 @@
 #define INCLUDE_ASTEXPRESSION_H
 
 #include "ast.h"
+#include "astbytecode.h"
 #include "location.hh"
 #include "cfdg.h"
 #include "shape.h"
@@ -161,6 +162,7 @@ namespace AST {
         Locality_t mLocality;
         expType mType;
         yy::location where;
+        code_ptr mCode;         // set by lower()
         
         ASTexpression(const yy::location& loc) : isConstant(false), isNatural(false),
         mLocality(UnknownLocal), mType(NoType), where(loc) {};
@@ -169,6 +171,10 @@ namespace AST {
         virtual ~ASTexpression() = default;
         virtual int evaluate(double* = nullptr, int = 0, RendererAST* = nullptr) const
         { return 0; }
+        int evaluateLowered(double* res, int length, RendererAST* rti) const;
+        // Same as evaluate(), using the bytecode from lower() if there is any
+        void lower();
+        // Compiles a numeric expression to bytecode, after Simplify
         virtual void evaluate(Modification&, bool, RendererAST*) const
         { CfdgError::Error(where, "Cannot convert this expression into an adjustment"); }
         virtual param_ptr evalArgs(RendererAST* = nullptr, const StackRule* = nullptr) const
@@ -226,17 +232,28 @@ namespace AST {
             RandDiscrete, RandGeometric
         };
         static FuncType GetFuncType(const std::string& func);
+        using ScalarFunc = double (*)(const double* args);
+        static ScalarFunc GetScalarFunc(FuncType t, int argcount, bool naturalArgs);
+            // nullptr unless t is a pure function of argcount scalars
         static const std::string& GetFuncName(ASTfunction::FuncType t);
         static bool RandStaticIsConst;      // hideous hack for JSON
+        static bool FastMath;
+            // set for polynomial sin/cos/tan/cot/exp, faster and within a
+            // few ulps
         FuncType functype;
         exp_ptr arguments;
         double random;
+        ScalarFunc scalarFunc = nullptr;
+            // direct call for pure functions of one or two scalars, chosen
+            // for the argument count and type when the function is simplified
         ASTfunction() = delete;
         ASTfunction(const std::string& func, exp_ptr args, Rand64& r,
                     const yy::location& nameLoc, const yy::location& argsLoc,
                     Builder* b);
         ~ASTfunction() final = default;
         int evaluate(double* res = nullptr, int length = 0, RendererAST* rti = nullptr) const final;
+        int evaluateScalar(double* res, const double* a, int count, RendererAST* rti) const;
+        // Functions of one or two scalar arguments, given the evaluated arguments
         void entropy(std::string& e) const final;
         ASTexpression* compile(CompilePhase ph, Builder* b) final;
         ASTexpression* simplify(Builder* b) final;
@@ -265,6 +282,8 @@ namespace AST {
         //ASTselect(const yy::location& loc)
         //: ASTexpression(loc), tupleSize(-1), indexCache(0) {}
         std::size_t getIndex(RendererAST* rti = nullptr) const;
+        std::size_t getIndex(double select) const;
+        friend class ASTbytecode;
     };
     class ASTruleSpecifier : public ASTexpression {
     public:
@@ -539,6 +558,8 @@ namespace AST {
         ASTarray& operator=(const ASTarray&) = delete;
         ~ASTarray() final;
         int evaluate(double* res = nullptr, int length = 0, RendererAST* rti = nullptr) const final;
+        bool fetch(double index_d, double* res, RendererAST* rti) const;
+        // Copies the element at index_d to res
         void entropy(std::string& e) const final;
         ASTexpression* simplify(Builder* b) final;
         ASTexpression* compile(CompilePhase ph, Builder* b) final;
@@ -184,7 +184,7 @@ namespace AST {
                        RendererAST* rti)
     {
         double data[3];
-        switch (e->evaluate(data, 3, rti)) {
+        switch (e->evaluateLowered(data, 3, rti)) {
             case 1:
                 data[1] = data[0];
                 data[0] = 0.0;
@@ -224,7 +224,7 @@ namespace AST {
     }
 
     ASTrule::ASTrule(int i)
-    : ASTreplacement(nullptr, CfdgError::Default, rule), mCachedPath(nullptr),
+    : ASTreplacement(nullptr, CfdgError::Default, rule),
       mWeight(1.0), isPath(true), mNameIndex(i), weightType(NoWeight)
     {
         if (primShape::shapeMap[i].total_vertices() > 0) {
@@ -326,38 +326,68 @@ namespace AST {
     
     ASTpathOp::~ASTpathOp() = default;
     
-    void 
-    ASTreplacement::replace(Shape& s, RendererAST* r) const
+    param_ptr
+    ASTreplacement::childArgs(const StackRule* parentArgs, int& shapeType,
+                              RendererAST* r) const
     {
         if (mShapeSpec.argSource == ASTruleSpecifier::NoArgs) {
-            s.mShapeType = mShapeSpec.shapeType;
-            s.mParameters = nullptr;
-        } else {
-            s.mParameters = mShapeSpec.evalArgs(r, s.mParameters.get());
-            if (mShapeSpec.argSource == ASTruleSpecifier::SimpleParentArgs)
-                s.mShapeType = mShapeSpec.shapeType;
-            else
-                s.mShapeType = s.mParameters->mRuleName;
-            if (s.mParameters && s.mParameters->mParamCount == 0)
-                s.mParameters.reset();
+            shapeType = mShapeSpec.shapeType;
+            return nullptr;
         }
+        param_ptr args = mShapeSpec.evalArgs(r, parentArgs);
+        if (mShapeSpec.argSource == ASTruleSpecifier::SimpleParentArgs)
+            shapeType = mShapeSpec.shapeType;
+        else
+            shapeType = args->mRuleName;
+        if (args && args->mParamCount == 0)
+            args.reset();
+        return args;
+    }
+    
+    void 
+    ASTreplacement::replace(Shape& s, RendererAST* r) const
+    {
+        s.mParameters = childArgs(s.mParameters.get(), s.mShapeType, r);
         r->mCurrentSeed ^= mChildChange.modData.mRand64Seed;
         r->mCurrentSeed();
-        mChildChange.evaluate(s.mWorldState, true, r);
+        if (mChildChange.modExp.empty())
+            s.mWorldState *= mChildChange.modData;  // precomposed by Simplify
+        else
+            mChildChange.evaluate(s.mWorldState, true, r);
         s.mAreaCache = s.mWorldState.area();
     }
     
+    Shape
+    ASTreplacement::makeChild(const Shape& parent, RendererAST* r) const
+    {
+        int type;
+        param_ptr args = childArgs(parent.mParameters.get(), type, r);
+        r->mCurrentSeed ^= mChildChange.modData.mRand64Seed;
+        r->mCurrentSeed();
+        bool precomposed = mChildChange.modExp.empty();
+        Shape child = precomposed ?
+            Shape(type, parent.mWorldState, mChildChange.modData, std::move(args)) :
+            Shape(type, parent.mWorldState, std::move(args));
+        if (!precomposed) {
+            mChildChange.evaluate(child.mWorldState, true, r);
+            child.mAreaCache = child.mWorldState.area();
+        }
+        return child;
+    }
+    
     void
     ASTreplacement::traverse(const Shape& parent, bool tr, RendererAST* r) const
     {
+        if (mRepType == replacement) {
+            Shape child = makeChild(parent, r);
+            child.mWorldState.mRand64Seed = r->mCurrentSeed;
+            child.mWorldState.mRand64Seed();
+            r->processShape(child);
+            return;
+        }
+        
         Shape child(parent);
         switch (mRepType) {
-            case replacement:
-                replace(child, r);
-                child.mWorldState.mRand64Seed = r->mCurrentSeed;
-                child.mWorldState.mRand64Seed();
-                r->processShape(child);
-                break;
             case op:
                 if (!tr)
                     child.mWorldState.m_transform.reset();
@@ -396,30 +426,80 @@ namespace AST {
         index.number = start;
         ++r->mStackSize;
         r->mLogicalStackTop = &index + 1;
-        for (;;) {
-            if (r->requestStop || Renderer::AbortEverything)
-                throw CfdgError(mLocation, "Stopping");
+        if (mBatchBody) {
+            traverseBatch(loopChild, index.number, end, step, r);
+        } else {
+            for (;;) {
+                if (r->requestStop || Renderer::AbortEverything)
+                    throw CfdgError(mLocation, "Stopping");
             
-            if (step > 0.0) {
-                if (index.number >= end)
-                    break;
-            } else {
-                if (index.number <= end)
-                    break;
+                if (step > 0.0) {
+                    if (index.number >= end)
+                        break;
+                } else {
+                    if (index.number <= end)
+                        break;
+                }
+                mLoopBody.traverse(loopChild, tr || opsOnly, r);
+                mChildChange.evaluate(loopChild.mWorldState, true, r);
+                index.number += step;
             }
-            mLoopBody.traverse(loopChild, tr || opsOnly, r);
-            mChildChange.evaluate(loopChild.mWorldState, true, r);
-            index.number += step;
         }
         mFinallyBody.traverse(loopChild, tr || opsOnly, r);
         --r->mStackSize;
         r->mLogicalStackTop = oldTop;
     }
     
+    void
+    ASTloop::traverseBatch(Shape& loopChild, double& index, double end,
+                           double step, RendererAST* r) const
+    // Loop iterations are expanded a batch at a time: first the world state of
+    // each child is gathered, then the body adjustment is composed into all of
+    // them, then they are handed to the renderer. The loop adjustment must
+    // still be applied one iteration at a time, as a running product, for the
+    // children to come out bit-for-bit the same as from traverse().
+    {
+        static const std::size_t BatchSize = 32;
+        const ASTreplacement& body = *mBatchBody;
+        const Modification& bodyMod = body.mChildChange.modData;
+        
+        int childType;
+        param_ptr childArgs = body.childArgs(loopChild.mParameters.get(), childType, r);
+        
+        std::array<Modification, BatchSize> states;
+        for (;;) {
+            if (r->requestStop || Renderer::AbortEverything)
+                throw CfdgError(mLocation, "Stopping");
+            
+            std::size_t count = 0;
+            while (count < BatchSize && (step > 0.0 ? index < end : index > end)) {
+                states[count++] = loopChild.mWorldState;
+                loopChild.mWorldState *= mChildChange.modData;
+                index += step;
+            }
+            
+            for (std::size_t i = 0; i < count; ++i)
+                states[i] *= bodyMod;
+            
+            for (std::size_t i = 0; i < count; ++i) {
+                Shape child(childType, states[i], childArgs);
+                r->mCurrentSeed ^= bodyMod.mRand64Seed;
+                r->mCurrentSeed();
+                child.mWorldState.mRand64Seed = r->mCurrentSeed;
+                child.mWorldState.mRand64Seed();
+                r->processShape(child);
+            }
+            r->mBatchedCount += static_cast<int>(count);
+            
+            if (count < BatchSize)
+                break;
+        }
+    }
+    
     void
     ASTtransform::traverse(const Shape& parent, bool tr, RendererAST* r) const
     {
-        static agg::trans_affine Dummy;
+        static const agg::trans_affine Dummy;
         SymmList transforms;
         std::vector<const ASTmodification*> mods = getTransforms(mExpHolder.get(), transforms, r, false, Dummy);
         
@@ -455,7 +535,7 @@ namespace AST {
     ASTif::traverse(const Shape& parent, bool tr, RendererAST* r) const
     {
         double cond = 0.0;
-        if (mCondition->evaluate(&cond, 1, r) != 1) {
+        if (mCondition->evaluateLowered(&cond, 1, r) != 1) {
             CfdgError::Error(mLocation, "Error evaluating if condition");
             return;
         }
@@ -494,7 +574,7 @@ namespace AST {
         
         switch (mType) {
             case NumericType:
-                if (mExpression->evaluate(&dest->number, mTuplesize, r) != mTuplesize)
+                if (mExpression->evaluateLowered(&dest->number, mTuplesize, r) != mTuplesize)
                     CfdgError::Error(mExpression->where, 
                                    "Error evaluating parameters (too many or not enough).");
                 break;
@@ -547,9 +627,8 @@ namespace AST {
         if (r->mOpsOnly)
             CfdgError::Error(mLocation, "Path commands not allowed at this point");
 
-        Shape child(s);
+        Shape child = makeChild(s, r);
         double width = mStrokeWidth;
-        replace(child, r);
         if (mParameters && mParameters->evaluate(&width, 1, r) != 1)
             CfdgError::Error(mParameters->where, "Error computing stroke width");
         
@@ -592,6 +671,54 @@ namespace AST {
         r->processPathCommand(child, info);
     }
     
+    PathCache::PathCache() = default;
+    
+    PathCache::~PathCache() = default;
+    
+    cpath_ptr
+    PathCache::take(const StackRule* params, const RendererAST* r)
+    {
+        std::size_t hash = StackRule::Hash(params);
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto it = mEntries.begin(), e = mEntries.end(); it != e; ++it) {
+            if (it->mHash == hash && it->mOwner == r &&
+                StackRule::Equal(it->mPath->mParameters.get(), params))
+            {
+                cpath_ptr ret = std::move(it->mPath);
+                mEntries.erase(it);
+                return ret;
+            }
+        }
+        return nullptr;
+    }
+    
+    void
+    PathCache::put(cpath_ptr path, const RendererAST* r)
+    {
+        std::size_t hash = StackRule::Hash(path->mParameters.get());
+        std::lock_guard<std::mutex> lock(mMutex);
+        // A recursive path may have compiled and returned the same path while
+        // the outer one was using it; keep one copy
+        for (auto it = mEntries.begin(), e = mEntries.end(); it != e; ++it) {
+            if (it->mHash == hash && it->mOwner == r &&
+                StackRule::Equal(it->mPath->mParameters.get(), path->mParameters.get()))
+            {
+                mEntries.erase(it);
+                break;
+            }
+        }
+        if (mEntries.size() >= Capacity)
+            mEntries.pop_back();
+        mEntries.push_front(Entry{hash, r, std::move(path)});
+    }
+    
+    void
+    PathCache::clear(const RendererAST* r)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEntries.remove_if([r](const Entry& e) { return e.mOwner == r; });
+    }
+    
     void
     ASTrule::traversePath(const Shape& parent, RendererAST* r) const
     {
@@ -601,9 +728,11 @@ namespace AST {
         
         cpath_ptr savedPath;
         
-        if (mCachedPath && StackRule::Equal(mCachedPath->mParameters.get(), parent.mParameters.get())) {
+        ++r->mPathCount;
+        if (cpath_ptr cached = mPathCache.take(parent.mParameters.get(), r)) {
+            ++r->mPathCacheHits;
             savedPath = std::move(r->mCurrentPath);
-            r->mCurrentPath = std::move(mCachedPath);
+            r->mCurrentPath = std::move(cached);
             r->mCurrentCommand = r->mCurrentPath->mCommandInfo.begin();
         } else {
             r->mCurrentPath->mTerminalCommand.mLocation = mLocation;
@@ -616,13 +745,13 @@ namespace AST {
             r->mCurrentPath->mTerminalCommand.traverse(parent, false, r);
         
         if (savedPath) {
-            mCachedPath = std::move(r->mCurrentPath);
+            mPathCache.put(std::move(r->mCurrentPath), r);
             r->mCurrentPath = std::move(savedPath);
         } else {
-            if (!(r->mRandUsed) && !mCachedPath) {
-                mCachedPath = std::move(r->mCurrentPath);
-                mCachedPath->mCached = true;
-                mCachedPath->mParameters = parent.mParameters;
+            if (!(r->mRandUsed)) {
+                r->mCurrentPath->mCached = true;
+                r->mCurrentPath->mParameters = parent.mParameters;
+                mPathCache.put(std::move(r->mCurrentPath), r);
                 r->mCurrentPath = std::make_unique<ASTcompiledPath>();
             } else {
                 r->mCurrentPath->mPath.remove_all();
@@ -765,9 +894,24 @@ namespace AST {
                     mLoopArgs.reset();
                     mLoopBody.mParameters.front().isNatural = bodyNatural;
                     mFinallyBody.mParameters.front().isNatural = finallyNatural;
+                } else {
+                    mLoopArgs->lower();
                 }
                 mLoopBody.compile(ph, b);
                 mFinallyBody.compile(ph, b);
+                
+                mBatchBody = nullptr;
+                if (mChildChange.modExp.empty() && mLoopBody.mBody.size() == 1) {
+                    const ASTreplacement* body = mLoopBody.mBody.front().get();
+                    if (typeid(*body) == typeid(ASTreplacement) &&
+                        body->mRepType == replacement &&
+                        body->mChildChange.modExp.empty() &&
+                        (body->mShapeSpec.argSource == ASTruleSpecifier::NoArgs ||
+                         body->mShapeSpec.argSource == ASTruleSpecifier::SimpleArgs))
+                    {
+                        mBatchBody = body;
+                    }
+                }
                 break;
         }
     }
@@ -823,9 +967,14 @@ namespace AST {
                 if (mCondition->mType != NumericType || mCondition->evaluate() != 1)
                     CfdgError::Error(mCondition->where, "If condition must be a numeric scalar", b);
                 break;
-            case CompilePhase::Simplify:
+            case CompilePhase::Simplify: {
                 Simplify(mCondition, b);
+                mCondition->lower();
+                double cond = 0.0;
+                if (mCondition->isConstant && mCondition->evaluate(&cond, 1) == 1)
+                    b->pruneBranch(cond != 0.0 ? mElseBody : mThenBody);
                 break;
+            }
         }
     }
     
@@ -899,14 +1048,38 @@ namespace AST {
                 }
                 break;
             }
-            case CompilePhase::Simplify:
+            case CompilePhase::Simplify: {
                 Simplify(mSwitchExp, b);
+                double caseValue = 0.0;
+                if (!mSwitchExp->isConstant || mSwitchExp->evaluate(&caseValue, 1) != 1)
+                    break;
+                caseType i = static_cast<caseType>(floor(caseValue));
+                auto it = mCaseMap.find(caseRange{i, i});
+                const ASTrepContainer* taken = it != mCaseMap.end() ? it->second : &mElseBody;
+                for (auto&& _case: mCases)
+                    if (_case.second.get() != taken)
+                        b->pruneBranch(*_case.second);
+                if (taken != &mElseBody)
+                    b->pruneBranch(mElseBody);
                 break;
+            }
         }
     }
     
     void
     ASTdefine::compile(AST::CompilePhase ph, Builder* b)
+    {
+        // Global definitions record their own use of frame time
+        bool global = b->mTimeShape < 0 && !b->mTimeDefine;
+        if (global && ph == CompilePhase::TypeCheck)
+            b->mTimeDefine = this;
+        compileDefinition(ph, b);
+        if (global)
+            b->mTimeDefine = nullptr;
+    }
+    
+    void
+    ASTdefine::compileDefinition(AST::CompilePhase ph, Builder* b)
     {
         if (mDefineType == FunctionDefine || mDefineType == LetDefine) {
             ASTrepContainer tempCont;
@@ -974,6 +1147,8 @@ namespace AST {
                     if (mDefineType == StackDefine) {
                         param.mStackIndex = b->mLocalStackDepth;
                         b->mLocalStackDepth += param.mTuplesize;
+                        if (b->mTimeDefine == this)
+                            b->mGlobalSlots[param.mStackIndex] = this;
                     }
                 }
                 break;
@@ -981,6 +1156,8 @@ namespace AST {
             case CompilePhase::Simplify:
                 if (mDefineType == ConfigDefine)
                     b->MakeConfig(this);
+                else if (mExpression)
+                    mExpression->lower();
                 break;
         }
     }
@@ -989,9 +1166,11 @@ namespace AST {
     ASTrule::compile(AST::CompilePhase ph, Builder* b)
     {
         b->mInPathContainer = isPath;
+        b->mTimeShape = mNameIndex;
         ASTreplacement::compile(ph, b);
         mRuleBody.compile(ph, b);
         b->mInPathContainer = false;
+        b->mTimeShape = -1;
     }
     
     void
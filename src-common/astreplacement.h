@@ -37,6 +37,7 @@
 #include <map>
 #include <list>
 #include <cstddef>
+#include <mutex>
 #include "CmdInfo.h"
 #include "agg2/agg_path_storage.h"
 
@@ -62,6 +63,12 @@ namespace AST {
         ASTmodification mChildChange;
         yy::location mLocation;
         void replace(Shape& s, RendererAST* r) const;
+        Shape makeChild(const Shape& parent, RendererAST* r) const;
+            // same as replace() on a copy of parent, but the child's world
+            // state is composed in place and the parent's parameters are
+            // never retained by a child that does not use them
+        param_ptr childArgs(const StackRule* parentArgs, int& shapeType,
+                            RendererAST* r) const;
         
         ASTreplacement(const ASTreplacement&) = delete;
         ASTreplacement(ruleSpec_ptr shapeSpec, mod_ptr mods,
@@ -120,6 +127,9 @@ namespace AST {
         ASTrepContainer mFinallyBody;
         int mLoopIndexName;
         std::string mLoopName;
+        const ASTreplacement* mBatchBody = nullptr;
+            // set by Simplify if the body is a single replacement with
+            // constant arguments and adjustments, as is the loop adjustment
         
         static void setupLoop(double& start, double& end, double& step, 
                               const ASTexpression* e, RendererAST* rti = nullptr);
@@ -132,6 +142,9 @@ namespace AST {
         void compile(CompilePhase ph, Builder* b) final;
         void compileLoopMod(Builder* b);
         void to_json(json& j) const final;
+    private:
+        void traverseBatch(Shape& loopChild, double& index, double end,
+                           double step, RendererAST* r) const;
     };
     class ASTtransform: public ASTreplacement {
     public:
@@ -201,12 +214,41 @@ namespace AST {
         ~ASTdefine() final = default;
         ASTdefine& operator=(const ASTdefine&) = delete;
         void to_json(json& j) const final;
+    private:
+        void compileDefinition(CompilePhase ph, Builder* b);
+    };
+    class PathCache {
+    public:
+        enum consts_t : std::size_t { Capacity = 8 };
+        
+        PathCache();
+        PathCache(const PathCache&) = delete;
+        PathCache& operator=(const PathCache&) = delete;
+        ~PathCache();
+        cpath_ptr take(const StackRule* params, const RendererAST* r);
+            // removes and returns the path that r compiled for params, or
+            // nullptr
+        void put(cpath_ptr path, const RendererAST* r);
+            // path is keyed by its mParameters and by r, as the path can
+            // depend on r's global variables. The least recently used path
+            // is dropped if the cache is full
+        void clear(const RendererAST* r);
+            // drops the paths compiled by r
+    private:
+        struct Entry {
+            std::size_t         mHash;
+            const RendererAST*  mOwner;
+            cpath_ptr           mPath;
+        };
+        std::list<Entry> mEntries;      // most recently used first
+        std::mutex mMutex;
     };
+    
     class ASTrule final : public ASTreplacement {
     public:
         enum WeightTypes { NoWeight = 1, PercentWeight = 2, ExplicitWeight = 4};
         ASTrepContainer mRuleBody;
-        mutable cpath_ptr mCachedPath;
+        mutable PathCache mPathCache;
         double mWeight;
         bool isPath;
         int mNameIndex;
@@ -215,14 +257,14 @@ namespace AST {
         static bool compareLT(const ASTrule* a, const ASTrule* b);
         
         ASTrule(int ruleIndex, double weight, bool percent, const yy::location& loc)
-        : ASTreplacement(nullptr, loc, rule), mCachedPath(nullptr),
+        : ASTreplacement(nullptr, loc, rule),
           mWeight(weight <= 0.0 ? 1.0 : weight), isPath(false), mNameIndex(ruleIndex),
           weightType(percent ? PercentWeight : ExplicitWeight) {
               if (weight <= 0.0)
                   CfdgError::Warning(loc, "Rule weight coerced to 1.0");
           };
         ASTrule(int ruleIndex, const yy::location& loc)
-        : ASTreplacement(nullptr, loc, rule), mCachedPath(nullptr),
+        : ASTreplacement(nullptr, loc, rule),
           mWeight(1.0), isPath(false), mNameIndex(ruleIndex), weightType(NoWeight) { };
         ASTrule(int i);
         ~ASTrule() final;
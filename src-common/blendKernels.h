@@ -0,0 +1,429 @@
+// blendKernels.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// The compositing formulas behind blendSpans, written once against a small
+// vector type that holds one or two RGBA pixels. Only blendSpansSSE41.cpp
+// and blendSpansAVX2.cpp include this. Everything is in an unnamed namespace
+// so that the copies compiled for different instruction sets never get
+// merged by the linker.
+//
+// The formulas are the ones in agg_pixfmt_rgba.h, evaluated in single
+// precision, so the results can be off from agg by one in the last bit.
+
+#ifndef INCLUDE_BLENDKERNELS_H
+#define INCLUDE_BLENDKERNELS_H
+
+#include "blendSpans.h"
+#include <cstring>
+
+#if defined(__SSE4_1__) || defined(__AVX__) || \
+    (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define BLENDSPANS_HAVE_SSE41 1
+#include <immintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define BLENDSPANS_HAVE_AVX2 1
+#endif
+
+#ifdef BLENDSPANS_HAVE_SSE41
+
+namespace blendSpans {
+namespace {
+    using agg::int8u;
+    using agg::int16u;
+    using agg::cover_type;
+
+    template<class T> struct channel;
+    template<> struct channel<int8u>  { static constexpr float scale = 255.0f; };
+    template<> struct channel<int16u> { static constexpr float scale = 65535.0f; };
+
+    //------------------------------------------------------- one pixel, SSE
+    struct Vsse {
+        static constexpr unsigned pixels = 1;
+        using tail = Vsse;
+        __m128 v;
+
+        Vsse() = default;
+        Vsse(__m128 x) : v(x) {}
+        explicit Vsse(float x) : v(_mm_set1_ps(x)) {}
+
+        static Vsse color(const float* c) { return _mm_loadu_ps(c); }
+        static Vsse covers(const cover_type* c)
+        { return _mm_set1_ps(c[0] * (1.0f / agg::cover_full)); }
+
+        static Vsse load(const int8u* p)
+        {
+            int x;
+            std::memcpy(&x, p, sizeof x);
+            __m128i i = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(x));
+            return _mm_mul_ps(_mm_cvtepi32_ps(i), _mm_set1_ps(1.0f / channel<int8u>::scale));
+        }
+        static Vsse load(const int16u* p)
+        {
+            __m128i i = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+            return _mm_mul_ps(_mm_cvtepi32_ps(i), _mm_set1_ps(1.0f / channel<int16u>::scale));
+        }
+        static Vsse load(const float* p) { return _mm_loadu_ps(p); }
+        __m128i round(float scale) const
+        {
+            __m128 x = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(scale)), _mm_set1_ps(0.5f));
+            return _mm_cvttps_epi32(_mm_max_ps(x, _mm_setzero_ps()));
+        }
+        void store(int8u* p) const
+        {
+            __m128i i = round(channel<int8u>::scale);
+            i = _mm_packus_epi32(i, i);
+            i = _mm_packus_epi16(i, i);
+            int x = _mm_cvtsi128_si32(i);
+            std::memcpy(p, &x, sizeof x);
+        }
+        void store(int16u* p) const
+        {
+            __m128i i = round(channel<int16u>::scale);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi32(i, i));
+        }
+        void store(float* p) const { _mm_storeu_ps(p, v); }
+
+        template<int A>
+        Vsse splat() const { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(A, A, A, A)); }
+        template<int A>
+        Vsse withAlpha(Vsse a) const { return _mm_blend_ps(v, a.v, 1 << A); }
+
+        friend Vsse operator+(Vsse a, Vsse b) { return _mm_add_ps(a.v, b.v); }
+        friend Vsse operator-(Vsse a, Vsse b) { return _mm_sub_ps(a.v, b.v); }
+        friend Vsse operator*(Vsse a, Vsse b) { return _mm_mul_ps(a.v, b.v); }
+        friend Vsse operator/(Vsse a, Vsse b) { return _mm_div_ps(a.v, b.v); }
+        friend Vsse vmin(Vsse a, Vsse b) { return _mm_min_ps(a.v, b.v); }
+        friend Vsse vmax(Vsse a, Vsse b) { return _mm_max_ps(a.v, b.v); }
+        friend Vsse vsqrt(Vsse a) { return _mm_sqrt_ps(a.v); }
+        friend Vsse operator<(Vsse a, Vsse b)  { return _mm_cmplt_ps(a.v, b.v); }
+        friend Vsse operator<=(Vsse a, Vsse b) { return _mm_cmple_ps(a.v, b.v); }
+        friend Vsse select(Vsse m, Vsse a, Vsse b) { return _mm_blendv_ps(b.v, a.v, m.v); }
+    };
+
+#ifdef BLENDSPANS_HAVE_AVX2
+    //------------------------------------------------------ two pixels, AVX2
+    struct Vavx2 {
+        static constexpr unsigned pixels = 2;
+        using tail = Vsse;
+        __m256 v;
+
+        Vavx2() = default;
+        Vavx2(__m256 x) : v(x) {}
+        explicit Vavx2(float x) : v(_mm256_set1_ps(x)) {}
+
+        static Vavx2 color(const float* c)
+        { return _mm256_broadcast_ps(reinterpret_cast<const __m128*>(c)); }
+        static Vavx2 covers(const cover_type* c)
+        {
+            float c0 = c[0] * (1.0f / agg::cover_full);
+            float c1 = c[1] * (1.0f / agg::cover_full);
+            return _mm256_setr_ps(c0, c0, c0, c0, c1, c1, c1, c1);
+        }
+
+        static Vavx2 load(const int8u* p)
+        {
+            __m256i i = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(i), _mm256_set1_ps(1.0f / channel<int8u>::scale));
+        }
+        static Vavx2 load(const int16u* p)
+        {
+            __m256i i = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(i), _mm256_set1_ps(1.0f / channel<int16u>::scale));
+        }
+        static Vavx2 load(const float* p) { return _mm256_loadu_ps(p); }
+        __m128i round(float scale) const
+        {
+            // Both pixels packed into 8 unsigned 16-bit values
+            __m256 x = _mm256_add_ps(_mm256_mul_ps(v, _mm256_set1_ps(scale)), _mm256_set1_ps(0.5f));
+            __m256i i = _mm256_cvttps_epi32(_mm256_max_ps(x, _mm256_setzero_ps()));
+            return _mm_packus_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+        }
+        void store(int8u* p) const
+        {
+            __m128i i = round(channel<int8u>::scale);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(i, i));
+        }
+        void store(int16u* p) const
+        { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), round(channel<int16u>::scale)); }
+        void store(float* p) const { _mm256_storeu_ps(p, v); }
+
+        template<int A>
+        Vavx2 splat() const { return _mm256_permute_ps(v, _MM_SHUFFLE(A, A, A, A)); }
+        template<int A>
+        Vavx2 withAlpha(Vavx2 a) const { return _mm256_blend_ps(v, a.v, (1 << A) | (16 << A)); }
+
+        friend Vavx2 operator+(Vavx2 a, Vavx2 b) { return _mm256_add_ps(a.v, b.v); }
+        friend Vavx2 operator-(Vavx2 a, Vavx2 b) { return _mm256_sub_ps(a.v, b.v); }
+        friend Vavx2 operator*(Vavx2 a, Vavx2 b) { return _mm256_mul_ps(a.v, b.v); }
+        friend Vavx2 operator/(Vavx2 a, Vavx2 b) { return _mm256_div_ps(a.v, b.v); }
+        friend Vavx2 vmin(Vavx2 a, Vavx2 b) { return _mm256_min_ps(a.v, b.v); }
+        friend Vavx2 vmax(Vavx2 a, Vavx2 b) { return _mm256_max_ps(a.v, b.v); }
+        friend Vavx2 vsqrt(Vavx2 a) { return _mm256_sqrt_ps(a.v); }
+        friend Vavx2 operator<(Vavx2 a, Vavx2 b)  { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+        friend Vavx2 operator<=(Vavx2 a, Vavx2 b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ); }
+        friend Vavx2 select(Vavx2 m, Vavx2 a, Vavx2 b) { return _mm256_blendv_ps(b.v, a.v, m.v); }
+    };
+#endif
+
+    //------------------------------------------------------------ formulas
+    // s and d are the premultiplied source (already scaled by the cover)
+    // and destination. sa and da are their alphas in every lane.
+
+    template<int A, class V>
+    V clip(V d)
+    // Same as agg::clip(): alpha to [0,1], colors to [0,alpha]
+    {
+        d = vmax(d, V(0.0f));
+        return vmin(d, vmin(d.template splat<A>(), V(1.0f)));
+    }
+
+    template<class V>
+    V sourceOver(V s, V d, V sa, V da)
+    // The parts of the source and destination outside of each other
+    { return s * (V(1.0f) - da) + d * (V(1.0f) - sa); }
+
+    template<class V>
+    V unionAlpha(V sa, V da)
+    { return da + (sa - sa * da); }
+
+    struct OpSrcOver {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V) { return s + (d - d * sa); }
+    };
+
+    struct OpClear {
+        static constexpr bool coverOnly = true;     // s is just the cover
+        template<int A, class V>
+        static V blend(V s, V d, V, V) { return d - d * s; }
+    };
+
+    struct OpXor {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da) { return sourceOver(s, d, sa, da); }
+    };
+
+    struct OpPlus {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V, V)
+        {
+            V t = d + s;
+            return clip<A>(vmin(t, vmin(t.template splat<A>(), V(1.0f))));
+        }
+    };
+
+    struct OpMultiply {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        { return clip<A>((s * d + s * (V(1.0f) - da) + d * (V(1.0f) - sa)).template withAlpha<A>(unionAlpha(sa, da))); }
+    };
+
+    struct OpScreen {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V, V) { return clip<A>(d + (s - s * d)); }
+    };
+
+    struct OpOverlay {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V two(2.0f);
+            V rest = sourceOver(s, d, sa, da);
+            V dark = two * s * d + rest;
+            V light = sa * da - two * (da - d) * (sa - s) + rest;
+            return clip<A>(select(two * d <= da, dark, light).template withAlpha<A>(unionAlpha(sa, da)));
+        }
+    };
+
+    struct OpDarken {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V c = vmin(s * da, d * sa) + sourceOver(s, d, sa, da);
+            return clip<A>(c.template withAlpha<A>(unionAlpha(sa, da)));
+        }
+    };
+
+    struct OpLighten {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V c = vmax(s * da, d * sa) + sourceOver(s, d, sa, da);
+            return clip<A>(c.template withAlpha<A>(unionAlpha(sa, da)));
+        }
+    };
+
+    struct OpColorDodge {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V zero(0.0f), one(1.0f);
+            V sada = sa * da;
+            V d1a = one - da, s1a = one - sa;
+            V dodge = sada * vmin(one, (d / da) * sa / (sa - s)) + s * d1a + d * s1a;
+            V full = sada + s * d1a + d * s1a;
+            V c = select(s < sa, dodge, select(zero < d, full, s * d1a));
+            c = clip<A>(c.template withAlpha<A>(unionAlpha(sa, da)));
+            return select(zero < da, c, s);
+        }
+    };
+
+    struct OpColorBurn {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V zero(0.0f), one(1.0f);
+            V sada = sa * da;
+            V d1a = one - da, s1a = one - sa;
+            V burn = sada * (one - vmin(one, (one - d / da) * sa / s)) + s * d1a + d * s1a;
+            V c = select(zero < s, burn, select(da < d, sada + d * s1a, d * s1a));
+            c = clip<A>(c.template withAlpha<A>(da + (sa - sada)));
+            return select(zero < da, c, s);
+        }
+    };
+
+    struct OpHardLight {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V two(2.0f);
+            V sada = sa * da;
+            V rest = sourceOver(s, d, sa, da);
+            V dark = two * s * d + rest;
+            V light = sada - two * (da - d) * (sa - s) + rest;
+            return clip<A>(select(two * s < sa, dark, light).template withAlpha<A>(da + (sa - sada)));
+        }
+    };
+
+    struct OpSoftLight {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V zero(0.0f), two(2.0f), four(4.0f);
+            V sada = sa * da;
+            V dcasa = d * sa;
+            V rest = sourceOver(s, d, sa, da);
+            V c1 = dcasa - (sada - two * s * da) * dcasa * (sada - dcasa) + rest;
+            V c2 = dcasa + (two * s * da - sada) *
+                   ((((V(16.0f) * dcasa - V(12.0f)) * dcasa + four) * d * da) - d * da) + rest;
+            V c3 = dcasa + (two * s * da - sada) * (vsqrt(dcasa) - dcasa) + rest;
+            V c = select(two * s <= sa, c1, select(four * d <= da, c2, c3));
+            c = clip<A>(c.template withAlpha<A>(da + (sa - sada)));
+            return select(zero < da, c, s);
+        }
+    };
+
+    struct OpDifference {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V c = d + (s - V(2.0f) * vmin(s * da, d * sa));
+            return clip<A>(c.template withAlpha<A>(unionAlpha(sa, da)));
+        }
+    };
+
+    struct OpExclusion {
+        static constexpr bool coverOnly = false;
+        template<int A, class V>
+        static V blend(V s, V d, V sa, V da)
+        {
+            V c = (s * da + d * sa - V(2.0f) * s * d) + sourceOver(s, d, sa, da);
+            return clip<A>(c.template withAlpha<A>(unionAlpha(sa, da)));
+        }
+    };
+
+    //--------------------------------------------------------------- spans
+    template<class V, int A, class Op, class T>
+    void span(T* p, unsigned len, const float* color, const cover_type* covers, cover_type cover)
+    {
+        V c = Op::coverOnly ? V(1.0f) : V::color(color);
+        V uniform = c * V(cover * (1.0f / agg::cover_full));
+        V zero(0.0f);
+        unsigned i = 0;
+        for (; i + V::pixels <= len; i += V::pixels, p += 4 * V::pixels) {
+            V s = covers ? c * V::covers(covers + i) : uniform;
+            V d = V::load(p);
+            V sa = s.template splat<A>();
+            V da = d.template splat<A>();
+            // Pixels that the source doesn't reach are left alone
+            select(zero < sa, Op::template blend<A>(s, d, sa, da), d).store(p);
+        }
+        if (i < len)
+            span<typename V::tail, A, Op>(p, len - i, color, covers ? covers + i : nullptr, cover);
+    }
+
+    template<class V, class Op>
+    void addOp(Kernels& k, agg::comp_op_e op)
+    {
+        k.span8[0][op]  = &span<V, 0, Op, int8u>;
+        k.span8[1][op]  = &span<V, 3, Op, int8u>;
+        k.span16[0][op] = &span<V, 0, Op, int16u>;
+        k.span16[1][op] = &span<V, 3, Op, int16u>;
+        k.span32[0][op] = &span<V, 0, Op, float>;
+        k.span32[1][op] = &span<V, 3, Op, float>;
+    }
+
+    template<class V>
+    Kernels makeKernels(const char* name)
+    {
+        Kernels k = { name, {}, {}, {} };
+        k.span32[0][agg::comp_op_src_over] = &span<V, 0, OpSrcOver, float>;
+        k.span32[1][agg::comp_op_src_over] = &span<V, 3, OpSrcOver, float>;
+            // integer src_over is left to agg, which is exact
+        addOp<V, OpClear>(k, agg::comp_op_clear);
+        addOp<V, OpXor>(k, agg::comp_op_xor);
+        addOp<V, OpPlus>(k, agg::comp_op_plus);
+        addOp<V, OpMultiply>(k, agg::comp_op_multiply);
+        addOp<V, OpScreen>(k, agg::comp_op_screen);
+        addOp<V, OpOverlay>(k, agg::comp_op_overlay);
+        addOp<V, OpDarken>(k, agg::comp_op_darken);
+        addOp<V, OpLighten>(k, agg::comp_op_lighten);
+        addOp<V, OpColorDodge>(k, agg::comp_op_color_dodge);
+        addOp<V, OpColorBurn>(k, agg::comp_op_color_burn);
+        addOp<V, OpHardLight>(k, agg::comp_op_hard_light);
+        addOp<V, OpSoftLight>(k, agg::comp_op_soft_light);
+        addOp<V, OpDifference>(k, agg::comp_op_difference);
+        addOp<V, OpExclusion>(k, agg::comp_op_exclusion);
+        return k;
+    }
+}
+}
+
+#endif  // BLENDSPANS_HAVE_SSE41
+
+#endif  // INCLUDE_BLENDKERNELS_H
@@ -0,0 +1,85 @@
+// blendSpans.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+#include "blendSpans.h"
+#include <initializer_list>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace {
+    bool cpuSupports(blendSpans::Isa isa)
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+        __cpuid(info, 1);
+        bool sse41 = (info[2] & (1 << 19)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (isa == blendSpans::Isa::SSE41)
+            return sse41;
+        // AVX2 also needs the OS to save the ymm registers
+        if (maxLeaf < 7 || !osxsave || !avx || (_xgetbv(0) & 6) != 6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        if (isa == blendSpans::Isa::SSE41)
+            return __builtin_cpu_supports("sse4.1");
+        return __builtin_cpu_supports("avx2");
+#else
+        (void)isa;
+        return false;
+#endif
+    }
+}
+
+const blendSpans::Kernels*
+blendSpans::kernels(Isa isa)
+{
+    if (!cpuSupports(isa))
+        return nullptr;
+    switch (isa) {
+        case Isa::SSE41:
+            return detail::sse41Kernels();
+        case Isa::AVX2:
+            return detail::avx2Kernels();
+    }
+    return nullptr;
+}
+
+const blendSpans::Kernels*
+blendSpans::best()
+{
+    static const Kernels* k = []() -> const Kernels* {
+        for (Isa isa: {Isa::AVX2, Isa::SSE41})
+            if (auto ks = kernels(isa))
+                return ks;
+        return nullptr;
+    }();
+    return k;
+}
@@ -0,0 +1,154 @@
+// blendSpans.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// Span-at-a-time versions of the compositing operations that CFDG exposes
+// through blend modes. The agg custom blend pixel formats look up the
+// compositing function for every pixel and compute in double precision.
+// These kernels blend a whole span with one solid color in single precision,
+// a pixel (SSE4.1) or two (AVX2) per vector. The instruction set is picked
+// once at startup from what the CPU supports. If there are no kernels for the
+// CPU then agg's per-pixel code does the blending, as before. Float buffers
+// (the accumulation buffer in aggCanvas) get a src_over kernel too.
+
+#ifndef INCLUDE_BLENDSPANS_H
+#define INCLUDE_BLENDSPANS_H
+
+#include "agg2/agg_basics.h"
+#include "agg2/agg_pixfmt_rgba.h"
+#include <type_traits>
+
+namespace blendSpans {
+    using span8_fn = void (*)(agg::int8u* p, unsigned len, const float* color,
+                              const agg::cover_type* covers, agg::cover_type cover);
+    using span16_fn = void (*)(agg::int16u* p, unsigned len, const float* color,
+                               const agg::cover_type* covers, agg::cover_type cover);
+    using span32_fn = void (*)(float* p, unsigned len, const float* color,
+                               const agg::cover_type* covers, agg::cover_type cover);
+        // color is the normalized, premultiplied source color in buffer
+        // order. If covers is null then cover is used for the whole span.
+
+    enum class Isa { SSE41, AVX2 };
+
+    struct Kernels {
+        const char* name;
+        span8_fn  span8[2][agg::end_of_comp_op_e];
+        span16_fn span16[2][agg::end_of_comp_op_e];
+        span32_fn span32[2][agg::end_of_comp_op_e];
+            // indexed by alpha first/last and compositing operation, null
+            // for operations that are left to agg
+    };
+
+    inline span8_fn  kernel(const Kernels& k, int alphaLast, unsigned op, agg::int8u*)
+    { return k.span8[alphaLast][op]; }
+    inline span16_fn kernel(const Kernels& k, int alphaLast, unsigned op, agg::int16u*)
+    { return k.span16[alphaLast][op]; }
+    inline span32_fn kernel(const Kernels& k, int alphaLast, unsigned op, float*)
+    { return k.span32[alphaLast][op]; }
+        // the kernel for a pixel buffer of the given channel type
+
+    const Kernels* kernels(Isa isa);
+        // null if the instruction set is not built in or not supported
+    const Kernels* best();
+        // the fastest supported kernels, or null if there are none
+
+    namespace detail {
+        const Kernels* sse41Kernels();
+        const Kernels* avx2Kernels();
+    }
+}
+
+namespace agg
+{
+    //----------------------------------------------------------------------------
+    //
+    // pixfmt_span_blend_rgba
+    //
+    // pixfmt_custom_blend_rgba with the solid span functions routed through
+    // the blendSpans kernels. Everything else is left to the base class.
+    //
+    //----------------------------------------------------------------------------
+    template<class Blender, class RenBuf>
+    class pixfmt_span_blend_rgba : public pixfmt_custom_blend_rgba<Blender, RenBuf>
+    {
+        using base_type = pixfmt_custom_blend_rgba<Blender, RenBuf>;
+        using order_type = typename base_type::order_type;
+        using value_type = typename base_type::value_type;
+    public:
+        using color_type = typename base_type::color_type;
+
+        pixfmt_span_blend_rgba() = default;
+        explicit pixfmt_span_blend_rgba(RenBuf& rb, unsigned comp_op = comp_op_src_over)
+        : base_type(rb, comp_op) {}
+
+        void blend_hline(int x, int y, unsigned len, const color_type& c, int8u cover)
+        {
+            if (!blend_span(x, y, len, c, nullptr, cover))
+                base_type::blend_hline(x, y, len, c, cover);
+        }
+
+        void blend_solid_hspan(int x, int y, unsigned len, const color_type& c,
+                               const int8u* covers)
+        {
+            if (!blend_span(x, y, len, c, covers, cover_full))
+                base_type::blend_solid_hspan(x, y, len, c, covers);
+        }
+
+    private:
+        bool blend_span(int x, int y, unsigned len, const color_type& c,
+                        const int8u* covers, int8u cover)
+        {
+            unsigned op = base_type::comp_op();
+            if (op == comp_op_src_over && !std::is_floating_point<value_type>::value) {
+                // Same integer blend that agg uses for src_over, without
+                // the per-pixel trip through the function table
+                using blender = blender_rgba_pre<color_type, order_type>;
+                auto* p = reinterpret_cast<value_type*>(base_type::pix_value_ptr(x, y, len));
+                for (unsigned i = 0; i < len; ++i, p += 4)
+                    blender::blend_pix(p, c.r, c.g, c.b, c.a, covers ? covers[i] : cover);
+                return true;
+            }
+
+            const int alphaLast = order_type::A == 3 ? 1 : 0;
+            if ((order_type::A != 0 && order_type::A != 3) || op >= end_of_comp_op_e)
+                return false;
+            const blendSpans::Kernels* k = blendSpans::best();
+            if (!k)
+                return false;
+            auto* p = reinterpret_cast<value_type*>(base_type::pix_value_ptr(x, y, len));
+            auto f = blendSpans::kernel(*k, alphaLast, op, p);
+            if (!f)
+                return false;
+
+            float color[4];
+            color[order_type::R] = static_cast<float>(color_type::to_double(c.r));
+            color[order_type::G] = static_cast<float>(color_type::to_double(c.g));
+            color[order_type::B] = static_cast<float>(color_type::to_double(c.b));
+            color[order_type::A] = static_cast<float>(color_type::to_double(c.a));
+            f(p, len, color, covers, cover);
+            return true;
+        }
+    };
+}
+
+#endif  // INCLUDE_BLENDSPANS_H
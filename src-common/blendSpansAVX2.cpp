@@ -0,0 +1,48 @@
+// blendSpansAVX2.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// The AVX2 kernels. This file is built with AVX2 code generation enabled
+// (-mavx2 or /arch:AVX2) and is only called into after checking the CPU.
+// Without that it builds to nothing and the kernels are not offered.
+
+#include "blendKernels.h"
+
+#ifdef BLENDSPANS_HAVE_AVX2
+
+const blendSpans::Kernels*
+blendSpans::detail::avx2Kernels()
+{
+    static const Kernels k = makeKernels<Vavx2>("AVX2");
+    return &k;
+}
+
+#else
+
+const blendSpans::Kernels*
+blendSpans::detail::avx2Kernels()
+{
+    return nullptr;
+}
+
+#endif
@@ -47,6 +47,23 @@ Bounds::Bounds(const agg::trans_affine& trans, pathIterator& helper, double scal
     }
 }
 
+// Primitive shapes are stroked polygons (the circle is bounded by its
+// pseudo-vertices), so their bounds come from a few transformed points.
+Bounds::Bounds(const agg::trans_affine& trans, const primShape& shape)
+{
+    if (!shape.boundingRect(trans, mMin_X, mMin_Y, mMax_X, mMax_Y))
+        invalidate();
+}
+
+// The extremes of a transformed shape are at transformed vertices of its hull.
+Bounds::Bounds(const agg::trans_affine& trans, const std::vector<agg::point_d>& hull)
+{
+    for (agg::point_d p: hull) {
+        trans.transform(&p.x, &p.y);
+        merge(p);
+    }
+}
+
 Bounds
 Bounds::interpolate(const Bounds& other, double alpha) const
 {
@@ -175,3 +192,17 @@ Bounds::update(const agg::trans_affine& trns, pathIterator& helper, double scale
     merge(b);
 }
 
+void
+Bounds::update(const agg::trans_affine& trns, const primShape& shape)
+{
+    Bounds b(trns, shape);
+    merge(b);
+}
+
+void
+Bounds::update(const agg::trans_affine& trns, const std::vector<agg::point_d>& hull)
+{
+    Bounds b(trns, hull);
+    merge(b);
+}
+
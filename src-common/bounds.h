@@ -33,6 +33,7 @@
 #include "agg2/agg_path_storage.h"
 #include <limits>
 #include <cmath>
+#include <vector>
 
 namespace agg { struct trans_affine; }
 namespace AST { 
@@ -40,6 +41,7 @@ namespace AST {
     struct CommandInfo; 
 }
 class pathIterator; 
+class primShape;
 
 class Bounds {
     public:
@@ -48,6 +50,10 @@ class Bounds {
         Bounds(const agg::trans_affine& trans, pathIterator& helper, 
                double scale, const AST::CommandInfo& attr);
                 // set bounds to be the bounds of this shape, transformed
+        Bounds(const agg::trans_affine& trans, const primShape& shape);
+                // same, for a primitive shape, without flattening it
+        Bounds(const agg::trans_affine& trans, const std::vector<agg::point_d>& hull);
+                // same, for a shape given by the convex hull of its outline
 
         bool valid() const { return std::isfinite(mMin_X) && std::isfinite(mMax_X) &&
                                     std::isfinite(mMin_Y) && std::isfinite(mMax_Y); }
@@ -118,6 +124,8 @@ class Bounds {
         
         void update(const agg::trans_affine& trns, pathIterator& helper, 
                     double scale, const AST::CommandInfo& attr);
+        void update(const agg::trans_affine& trns, const primShape& shape);
+        void update(const agg::trans_affine& trns, const std::vector<agg::point_d>& hull);
     
         bool overlaps(const Bounds& other) const
         {
@@ -110,8 +110,8 @@ int Builder::MaxNaturalDepth = std::numeric_limits<int>::max();
 Builder::Builder(const cfdgi_ptr& cfdg, int variation)
 : m_CFDG(cfdg), m_currentPath(nullptr), m_pathCount(1),
   mInPathContainer(false), mCurrentShape(-1), mParamSize(0),
-  mLocalStackDepth(0), mIncludeDepth(0), mAllowOverlap(false), lexer(nullptr),
-  mErrorOccured(false)
+  mLocalStackDepth(0), mIncludeDepth(0), mAllowOverlap(false),
+  mTimeShape(-1), mTimeDefine(nullptr), lexer(nullptr), mErrorOccured(false)
 {
     mBuilderThread = std::this_thread::get_id();
     //CommandInfo::shapeMap[0].mArea = M_PI * 0.25;
@@ -742,6 +742,8 @@ Builder::MakeFunction(str_ptr name, exp_ptr args, const yy::location& nameLoc,
     ASTfunction::FuncType t = ASTfunction::GetFuncType(*name);
     if (t == ASTfunction::Ftime || t == ASTfunction::Frame)
         m_CFDG->addParameter(CFDGImpl::FrameTime);
+    if (t == ASTfunction::Rand_Static)
+        m_CFDG->usesRandStatic = true;
     if (t != ASTfunction::NotAFunction)
         return new ASTfunction(*name, std::move(args), mSeed, nameLoc, argsLoc, this);
     
@@ -942,3 +944,79 @@ Builder::impure() const noexcept
     return m_CFDG->m_impure;
 }
 
+Builder::FrameTimeUse*
+Builder::timeUser()
+{
+    if (mTimeShape >= 0)
+        return &mShapeTimeUse[mTimeShape];
+    if (mTimeDefine)
+        return &mDefineTimeUse[mTimeDefine];
+    return nullptr;
+}
+
+void
+Builder::readsFrameTime()
+{
+    if (FrameTimeUse* user = timeUser())
+        user->reads = true;
+}
+
+void
+Builder::usesDefinition(const ASTdefine* def)
+{
+    FrameTimeUse* user = timeUser();
+    if (user && def)
+        user->uses.push_back(def);
+}
+
+void
+Builder::usesGlobal(int stackIndex)
+{
+    auto it = mGlobalSlots.find(stackIndex);
+    if (it != mGlobalSlots.end())
+        usesDefinition(it->second);
+}
+
+void
+Builder::referenceShape(int shapeType)
+{
+    if (shapeType < 0 || shapeType == mTimeShape || !m_CFDG->shapeHasRules(shapeType))
+        return;
+    mShapeReferences.push_back({mTimeShape, shapeType,
+        {mContainerStack.begin(), mContainerStack.end()}});
+}
+
+void
+Builder::pruneBranch(ASTrepContainer& c)
+{
+    if (c.mBody.empty())
+        return;
+    c.mBody.clear();
+    mPrunedContainers.insert(&c);
+    ++mPrunedBranches;
+}
+
+void
+Builder::resolveFrameTime()
+{
+    // A definition reads frame time if anything that it uses does. Iterate
+    // until nothing changes, functions can be recursive.
+    auto readsVia = [this](const FrameTimeUse& use) {
+        for (const ASTdefine* def: use.uses) {
+            auto it = mDefineTimeUse.find(def);
+            if (it != mDefineTimeUse.end() && it->second.reads)
+                return true;
+        }
+        return false;
+    };
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (auto& use: mDefineTimeUse)
+            if (!use.second.reads && readsVia(use.second))
+                use.second.reads = changed = true;
+    }
+    for (auto& use: mShapeTimeUse)
+        if (use.second.reads || readsVia(use.second))
+            m_CFDG->setShapeReadsFrameTime(use.first);
+}
+
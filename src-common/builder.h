@@ -40,6 +40,7 @@
 #include <string>
 #include <cstdlib>
 #include <map>
+#include <set>
 #include <thread>
 #include <mutex>
 #include "agg2/agg_basics.h"
@@ -104,6 +105,39 @@ public:
     AbstractSystem*     system();
     
     std::stack<AST::ASTswitch*> switchStack;
+    
+    // Which rules and global definitions read ftime() or frame(), directly or
+    // through the functions and global variables that they use. Recorded
+    // during type check and resolved into the shape types afterwards.
+    struct FrameTimeUse {
+        bool reads = false;
+        std::vector<const AST::ASTdefine*> uses;
+    };
+    int                     mTimeShape;     // shape of the rule being type checked
+    const AST::ASTdefine*   mTimeDefine;    // global definition being type checked
+    std::map<int, FrameTimeUse> mShapeTimeUse;
+    std::map<const AST::ASTdefine*, FrameTimeUse> mDefineTimeUse;
+    std::map<int, const AST::ASTdefine*> mGlobalSlots;  // by stack index
+    FrameTimeUse*       timeUser();
+    void                readsFrameTime();
+    void                usesDefinition(const AST::ASTdefine* def);
+    void                usesGlobal(int stackIndex);
+    void                resolveFrameTime();
+    
+    // Which rules each rule (or global code, as -1) refers to, recorded
+    // during type check along with the containers around the reference.
+    // References inside branches that simplify away do not count when the
+    // unreachable rules are pruned.
+    struct ShapeReference {
+        int from;
+        int to;
+        std::vector<const AST::ASTrepContainer*> scope;
+    };
+    std::vector<ShapeReference> mShapeReferences;
+    std::set<const AST::ASTrepContainer*> mPrunedContainers;
+    int                 mPrunedBranches = 0;
+    void                referenceShape(int shapeType);
+    void                pruneBranch(AST::ASTrepContainer& c);
 
     yy::Scanner*    lexer;
     void    warning(const yy::location& errLoc, const std::string& msg);
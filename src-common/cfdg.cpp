@@ -47,8 +47,8 @@
 
 yy::location CfdgError::Default;
 double Renderer::Infinity = std::numeric_limits<double>::infinity();      // Ignore the gcc warning
-bool Renderer::AbortEverything = false;
-unsigned Renderer::ParamCount = 0;
+std::atomic<bool> Renderer::AbortEverything(false);
+std::atomic<unsigned> Renderer::ParamCount(0);
 const CfgArray<std::string> CFDG::ParamNames = {
     "CF::AllowOverlap",
     "CF::Alpha",
@@ -47,6 +47,7 @@
 #include <cstdint>
 #include <cstddef>
 #include <array>
+#include <atomic>
 
 #define _unused(x) ((void)(x))
 
@@ -134,6 +135,10 @@ class AbstractSystem {
         struct Stats {
             int     shapeCount = 0;     // finished shapes in image
             int     toDoCount = 0;      // unfinished shapes still to expand
+            int     culledCount = 0;    // shapes skipped for being off canvas
+            int     batchedCount = 0;   // loop iterations expanded in batches
+            int     pathCount = 0;      // path rules traversed
+            int     pathCacheHits = 0;  // paths that did not need compiling
             
             bool    inOutput = false;       // true if we are in the output loop
             bool    fullOutput = false;     // not an incremental output
@@ -142,6 +147,7 @@ class AbstractSystem {
             int     outputCount = 0;    // number to be output
             int     outputDone = 0;     // number output so far
             std::clock_t outputTime = 0;
+            double  outputStall = 0.0;  // seconds waiting for the encoder
 
             bool    animating = false;      // inside the animation loop
             AbstractSystem* mSystem = nullptr;
@@ -186,6 +192,7 @@ class Canvas {
         int mWidth;
         int mHeight;
         std::clock_t mTime = (std::clock_t)(-1);
+        double mStallTime = 0.0;    // seconds spent waiting for the output
         bool mError;
         std::string mFileName;
 };
@@ -215,6 +222,9 @@ class CFDG {
         bool usesBlendMode = false;
         bool usesTime = false;
         bool usesFrameTime = false;
+        bool usesRandStatic = false;    // so the design depends on the variation
+        int prunedRules = 0;            // unreachable from the start shape
+        int prunedBranches = 0;         // if/switch bodies with constant conditions
         static const CfgArray<std::string>  ParamNames;
         static CFG lookupCfg(const std::string& name);
         static const std::string& getCfgName(int c);
@@ -224,7 +234,7 @@ class CFDG {
         virtual frieze_t isFrieze(agg::trans_affine* tr = nullptr, double* x = nullptr, double* y = nullptr) const = 0;
         virtual bool isSized(double* x = nullptr, double* y = nullptr) const = 0;
         virtual bool isTimed(agg::trans_affine_time* t = nullptr) const = 0;
-        virtual const agg::rgba& getBackgroundColor() = 0;
+        virtual agg::rgba getBackgroundColor(Renderer* r) const = 0;
         virtual void serialize(std::ostream&) = 0;
 
     protected:
@@ -238,6 +248,7 @@ class Renderer {
         virtual ~Renderer();
         
         virtual void setMaxShapes(int n) = 0;        
+        virtual void setFrameJobs(int n) = 0;
         virtual void resetBounds() = 0;
         virtual void resetSize(int x, int y) = 0;
 
@@ -254,8 +265,8 @@ class Renderer {
         std::unique_ptr<tiledCanvas> m_tiledCanvas;
     
         static double Infinity;
-        static bool   AbortEverything;
-        static unsigned ParamCount;
+        static std::atomic<bool>     AbortEverything;
+        static std::atomic<unsigned> ParamCount;
     protected:
         Renderer(int w, int h);
 };
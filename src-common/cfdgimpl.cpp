@@ -55,10 +55,10 @@ using namespace AST;
 
 
 CFDGImpl::CFDGImpl(AbstractSystem* m)
-: mPostDtorCleanup(m), m_backgroundColor(1, 1, 1, 1), mStackSize(0),
+: mPostDtorCleanup(m), mStackSize(0),
   mInitShape(nullptr), m_system(m), m_builder(nullptr), m_impure(false),
   m_Parameters(0), ParamDepth({NoParameter}),
-  mTileOffset(0, 0), needle(0, CfdgError::Default)
+  mTileOffset(0, 0)
 {
     // Initialize the shape table with the primitive shapes so that they get the
     // shape number that matches their primitive shape number.
@@ -142,32 +142,37 @@ CFDGImpl::getInitialShape(RendererAST* r)
     return init;
 }
 
-const agg::rgba&
-CFDGImpl::getBackgroundColor()
+agg::rgba
+CFDGImpl::getBackgroundColor(Renderer* r) const
 {
-    return m_backgroundColor;
+    if (auto* ri = dynamic_cast<RendererImpl*>(r))
+        return ri->backgroundColor();
+    return agg::rgba(1, 1, 1, 1);
 }
 
-void
-CFDGImpl::setBackgroundColor(RendererAST* r)
+agg::rgba
+CFDGImpl::calcBackgroundColor(RendererAST* r) const
 {
+    agg::rgba color(1, 1, 1, 1);
     Modification white;
     white.m_Color = HSBColor(0.0, 0.0, 1.0, 1.0);
     if (hasParameter(CFG::Background, white, r)) {
-        white.m_Color.getRGBA(m_backgroundColor);
+        white.m_Color.getRGBA(color);
         if (!usesAlpha)
-            m_backgroundColor.a = 1.0;
+            color.a = 1.0;
     }
+    return color;
 }
 
 const ASTrule*
 CFDGImpl::findRule(int shapetype, double r)
 {
-    needle.mNameIndex = shapetype;
-    needle.mWeight = r;
-    
-    auto first = lower_bound(mRules.cbegin(), mRules.cend(),
-                             &needle, ASTrule::compareLT);
+    // Same order as ASTrule::compareLT, without a shared search key
+    auto before = [shapetype](const ASTrule* rule, double weight) {
+        return rule->mNameIndex < shapetype ||
+               (rule->mNameIndex == shapetype && rule->mWeight < weight);
+    };
+    auto first = std::lower_bound(mRules.cbegin(), mRules.cend(), r, before);
     if (first == mRules.cend() || (*first)->mNameIndex != shapetype)
         throw CfdgError("Cannot find a rule for a shape (very helpful I know).");
     return *first;
@@ -462,8 +467,11 @@ CFDGImpl::rulesLoaded()
         m_builder->mInPathContainer = false;
         mCFDGcontents.compile(CompilePhase::TypeCheck, m_builder);
         m_builder->mInPathContainer = false;
-        if (!m_builder->mErrorOccured)
+        if (!m_builder->mErrorOccured) {
             mCFDGcontents.compile(CompilePhase::Simplify, m_builder);
+            pruneRules();
+        }
+        m_builder->resolveFrameTime();
     } catch (DeferUntilRuntime&) {
         CfdgError::Error(CfdgError::Default, "Unexpected exception during compile.");
     }
@@ -488,6 +496,47 @@ CFDGImpl::rulesLoaded()
         }
 }
 
+void
+CFDGImpl::pruneRules()
+// Drops the rules that cannot be reached from global code (which includes
+// the start shape), following only the references that are not inside
+// if/switch bodies that Simplify found to be dead.
+{
+    std::vector<std::vector<int>> refs(m_shapeTypes.size());
+    std::vector<int> todo;
+    for (auto&& ref: m_builder->mShapeReferences) {
+        if (std::any_of(ref.scope.begin(), ref.scope.end(),
+                        [this](const ASTrepContainer* c)
+                        { return m_builder->mPrunedContainers.count(c) != 0; }))
+            continue;
+        if (ref.from < 0)
+            todo.push_back(ref.to);
+        else
+            refs[ref.from].push_back(ref.to);
+    }
+    
+    std::vector<bool> reachable(m_shapeTypes.size(), false);
+    while (!todo.empty()) {
+        int shape = todo.back();
+        todo.pop_back();
+        if (reachable[shape])
+            continue;
+        reachable[shape] = true;
+        todo.insert(todo.end(), refs[shape].begin(), refs[shape].end());
+    }
+    
+    auto dead = [&reachable](const ASTrule* r) { return !reachable[r->mNameIndex]; };
+    auto last = std::remove_if(mRules.begin(), mRules.end(), dead);
+    prunedRules = static_cast<int>(mRules.end() - last);
+    mRules.erase(last, mRules.end());
+    auto& body = mCFDGcontents.mBody;
+    body.erase(std::remove_if(body.begin(), body.end(), [&dead](const rep_ptr& rep) {
+        auto rule = dynamic_cast<const ASTrule*>(rep.get());
+        return rule && dead(rule);
+    }), body.end());
+    prunedBranches = m_builder->mPrunedBranches;
+}
+
 int
 CFDGImpl::numRules()
 {
@@ -572,6 +621,21 @@ CFDGImpl::getShapeHasNoParams(int shapetype)
     return false;
 }
 
+void
+CFDGImpl::setShapeReadsFrameTime(int shapetype)
+{
+    if (shapetype < int(m_shapeTypes.size()))
+        m_shapeTypes[shapetype].readsFrameTime = true;
+}
+
+bool
+CFDGImpl::shapeReadsFrameTime(int shapetype) const
+{
+    if (shapetype < int(m_shapeTypes.size()))
+        return m_shapeTypes[shapetype].readsFrameTime;
+    return true;
+}
+
 const char* 
 CFDGImpl::setShapeParams(int shapetype, AST::ASTrepContainer& p, int argSize, bool isPath)
 {
@@ -624,10 +688,10 @@ CFDGImpl::reportStackDepth(int size)
 }
 
 void
-CFDGImpl::resetCachedPaths()
+CFDGImpl::resetCachedPaths(const RendererAST* r)
 {
     for (ASTrule* rule: mRules)
-        rule->mCachedPath.reset();
+        rule->mPathCache.clear(r);
 }
 
 AST::ASTdefine*
@@ -650,16 +714,17 @@ CFDGImpl::findFunction(int nameIndex)
     return nullptr;
 }
 
-renderer_ptr
-CFDGImpl::renderer(const cfdg_ptr& ptr, int width, int height, double minSize,
-                    int variation, double border)
+bool
+CFDGImpl::setupRendering()
 {
+    // Turns the startshape into the initial replacement and reads the tile,
+    // size and time settings. Runs once, for the first renderer.
     ASTexpression* startExp = ParamExp[CFG::StartShape].get();
     
     if (!startExp) {
         m_system->message("No startshape found");
         m_system->error();
-        return nullptr;
+        return false;
     }
 
     if (ASTstartSpecifier* startSpec = dynamic_cast<ASTstartSpecifier*>(startExp)) {
@@ -672,17 +737,13 @@ CFDGImpl::renderer(const cfdg_ptr& ptr, int width, int height, double minSize,
         CfdgError err(startExp->where, "Type error in startshape");
         m_system->error();
         m_system->syntaxError(err);
-        return nullptr;
+        return false;
     }
 
-    std::unique_ptr<RendererImpl> r;
     try {
-        r = std::make_unique<RendererImpl>(ptr, width, height, minSize, variation, border);
-        r->mImpure = m_impure;
         Modification tiled;
         Modification sized;
         Modification timed;
-        double       maxShape;
         if (hasParameter(CFG::Tile, tiled, nullptr)) {
             mTileMod = tiled;
             mTileOffset.x = mTileMod.m_transform.tx;
@@ -706,7 +767,7 @@ CFDGImpl::renderer(const cfdg_ptr& ptr, int width, int height, double minSize,
                 CfdgError err(loc, "Illegal CF::Time specification");
                 m_system->error();
                 m_system->syntaxError(err);
-                return nullptr;
+                return false;
             }
             mTimeMod = timed;
             double frame_v, ftime_v;
@@ -728,6 +789,29 @@ CFDGImpl::renderer(const cfdg_ptr& ptr, int width, int height, double minSize,
                 }
             }
         }
+    } catch (CfdgError& e) {
+        m_system->error();
+        m_system->syntaxError(e);
+        return false;
+    }
+    return true;
+}
+
+renderer_ptr
+CFDGImpl::renderer(const cfdg_ptr& ptr, int width, int height, double minSize,
+                    int variation, double border)
+{
+    // The design is not changed after this, so renderers for it can run on
+    // several threads at once
+    std::call_once(mRenderSetup, [this]() { mRenderReady = setupRendering(); });
+    if (!mRenderReady)
+        return nullptr;
+
+    std::unique_ptr<RendererImpl> r;
+    try {
+        r = std::make_unique<RendererImpl>(ptr, width, height, minSize, variation, border);
+        r->mImpure = m_impure;
+        double       maxShape;
         if (hasParameter(CFG::MaxShapes, maxShape, r.get())) {
             if (maxShape > 1)
                 r->setMaxShapes(static_cast<int>(maxShape));
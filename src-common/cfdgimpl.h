@@ -36,6 +36,7 @@
 #include <map>
 #include <deque>
 #include <type_traits>
+#include <mutex>
 
 #include "agg2/agg_color_rgba.h"
 #include "cfdg.h"
@@ -64,7 +65,6 @@ class CFDGImpl : public CFDG {
         };
     
         PostDtorCleanup mPostDtorCleanup;
-        agg::rgba m_backgroundColor;
     
         int mStackSize;
 
@@ -79,11 +79,12 @@ class CFDGImpl : public CFDG {
             std::unique_ptr<AST::ASTparameters> parameters;
             int     argSize;
             bool    shouldHaveNoParams;
+            bool    readsFrameTime;     // rules read ftime()/frame()
             
             ShapeType(std::string s, std::wstring cname, const yy::location& where)
             : name(std::move(s)), canonicalName(std::move(cname)), firstUse(where), hasRules(false),
               isShape(false), shapeType(newShape), parameters(nullptr), argSize(0),
-              shouldHaveNoParams(false) { }
+              shouldHaveNoParams(false), readsFrameTime(false) { }
 
             ShapeType(ShapeType&& from) noexcept = default;
             ShapeType& operator=(ShapeType&& from) noexcept(std::is_nothrow_move_assignable<std::string>::value)
@@ -96,6 +97,7 @@ class CFDGImpl : public CFDG {
                 parameters = std::move(from.parameters);
                 argSize = from.argSize;
                 shouldHaveNoParams = from.shouldHaveNoParams;
+                readsFrameTime = from.readsFrameTime;
                 return *this;
             }
             ShapeType(const ShapeType&) = delete;
@@ -127,7 +129,9 @@ class CFDGImpl : public CFDG {
         Modification mTimeMod;
         agg::point_d mTileOffset;
     
-        AST::ASTrule needle;
+        std::once_flag mRenderSetup;
+        bool mRenderReady = false;
+        bool setupRendering();
         
     public:
         CFDGImpl(AbstractSystem*);
@@ -141,9 +145,9 @@ class CFDGImpl : public CFDG {
         frieze_t isFrieze(agg::trans_affine* tr = nullptr, double* x = nullptr, double* y = nullptr) const override;
         bool isSized(double* x = nullptr, double* y = nullptr) const override;
         bool isTimed(agg::trans_affine_time* t = nullptr) const override;
-        const agg::rgba& getBackgroundColor() override;
+        agg::rgba getBackgroundColor(Renderer* r) const override;
         void serialize(std::ostream&) override;
-        void setBackgroundColor(RendererAST* r);
+        agg::rgba calcBackgroundColor(RendererAST* r) const;
         void getSymmetry(AST::SymmList& syms, RendererAST* r);
     
         const AST::ASTexpression* hasParameter(CFG name) const;
@@ -160,6 +164,7 @@ class CFDGImpl : public CFDG {
         
         bool addRule(AST::ASTrule* r);
         void rulesLoaded();
+        void pruneRules();
         int numRules();
         const AST::ASTrule* findRule(int shapetype, double r);
         const AST::ASTrule* findRule(int shapetype);
@@ -174,10 +179,12 @@ class CFDGImpl : public CFDG {
         const char* setShapeParams(int shapetype, AST::ASTrepContainer& p, int size, bool isPath);
         void    setShapeHasNoParams(int shapetype, const AST::ASTexpression* args);
         bool    getShapeHasNoParams(int shapetype);
+        void    setShapeReadsFrameTime(int shapetype);
+        bool    shapeReadsFrameTime(int shapetype) const;
         const AST::ASTparameters* getShapeParams(int shapetype) const;
         int getShapeParamSize(int shapetype);
         int reportStackDepth(int size = 0); 
-        void resetCachedPaths();
+        void resetCachedPaths(const RendererAST* r);
 
         AST::ASTdefine* declareFunction(int nameIndex, AST::ASTdefine* def);
         AST::ASTdefine* findFunction(int nameIndex);
@@ -0,0 +1,180 @@
+// colorPalette.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+#include "colorPalette.h"
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <cassert>
+
+#define PaletteBandRows 64
+
+namespace {
+    unsigned
+    tableSize(unsigned maxColors)
+    // Power of two that keeps the hash table at most a quarter full
+    {
+        unsigned size = 16;
+        while (size < maxColors * 4)
+            size <<= 1;
+        return size;
+    }
+
+    inline unsigned
+    hash(agg::int64u pixel, unsigned mask)
+    {
+        return static_cast<unsigned>((pixel * 0x9E3779B97F4A7C15ULL) >> 40) & mask;
+    }
+
+    class colorSet {
+    public:
+        std::vector<agg::int64u> colors;
+
+        colorSet(unsigned maxColors)
+        : slots(tableSize(maxColors), -1), mask(tableSize(maxColors) - 1), limit(maxColors)
+        { colors.reserve(maxColors); }
+
+        bool insert(agg::int64u pixel)
+        // false if pixel is new and the set is full
+        {
+            for (unsigned i = hash(pixel, mask); ; i = (i + 1) & mask) {
+                int slot = slots[i];
+                if (slot < 0) {
+                    if (colors.size() >= limit)
+                        return false;
+                    slots[i] = static_cast<int>(colors.size());
+                    colors.push_back(pixel);
+                    return true;
+                }
+                if (colors[slot] == pixel)
+                    return true;
+            }
+        }
+
+    private:
+        std::vector<int> slots;
+        unsigned mask;
+        unsigned limit;
+    };
+}
+
+agg::int64u
+colorPalette::pack(const agg::int8u* p, unsigned bytesPerPixel)
+{
+    agg::int64u pixel = 0;
+    std::memcpy(&pixel, p, bytesPerPixel);
+    return pixel;
+}
+
+void
+colorPalette::unpack(agg::int64u pixel, agg::int8u* p, unsigned bytesPerPixel)
+{
+    std::memcpy(p, &pixel, bytesPerPixel);
+}
+
+colorPalette::colorPalette(const agg::int8u* data, unsigned width, unsigned height,
+                           int stride, unsigned bytesPerPixel, unsigned maxColors)
+: mBytesPerPixel(bytesPerPixel), mFits(false)
+{
+    assert(bytesPerPixel > 0 && bytesPerPixel <= sizeof(agg::int64u));
+
+    std::atomic<bool> tooMany(false);
+    auto scan = [=, &tooMany](unsigned y1, unsigned y2, colorSet* set) {
+        for (unsigned y = y1; y < y2 && !tooMany; ++y) {
+            const agg::int8u* p = data + static_cast<std::ptrdiff_t>(y) * stride;
+            agg::int64u last = 0;
+            // Runs of the same pixel only need to be looked up once
+            for (unsigned x = 0; x < width; ++x, p += bytesPerPixel) {
+                agg::int64u pixel = pack(p, bytesPerPixel);
+                if ((pixel == last && x) || set->insert(pixel)) {
+                    last = pixel;
+                    continue;
+                }
+                tooMany = true;
+                return;
+            }
+        }
+    };
+
+    unsigned bands = std::min(std::thread::hardware_concurrency(), height / PaletteBandRows);
+    bands = std::max(bands, 1u);
+
+    std::vector<colorSet> sets(bands, colorSet(maxColors));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < bands; ++i)
+        workers.emplace_back(scan, height * i / bands, height * (i + 1) / bands, &sets[i]);
+    scan(0, height / bands, &sets[0]);
+    for (auto&& worker: workers)
+        worker.join();
+    if (tooMany)
+        return;
+
+    for (unsigned i = 1; i < bands; ++i)
+        for (agg::int64u pixel: sets[i].colors)
+            if (!sets[0].insert(pixel))
+                return;
+
+    mColors = std::move(sets[0].colors);
+    mFits = true;
+    rehash();
+}
+
+void
+colorPalette::rehash()
+{
+    mSlots.assign(tableSize(static_cast<unsigned>(mColors.size())), -1);
+    unsigned mask = static_cast<unsigned>(mSlots.size()) - 1;
+    for (int c = 0; c < static_cast<int>(mColors.size()); ++c) {
+        unsigned i = hash(mColors[c], mask);
+        while (mSlots[i] >= 0)
+            i = (i + 1) & mask;
+        mSlots[i] = c;
+    }
+}
+
+int
+colorPalette::find(agg::int64u pixel) const
+{
+    unsigned mask = static_cast<unsigned>(mSlots.size()) - 1;
+    for (unsigned i = hash(pixel, mask); mSlots[i] >= 0; i = (i + 1) & mask)
+        if (mColors[mSlots[i]] == pixel)
+            return mSlots[i];
+    return -1;
+}
+
+void
+colorPalette::indexRow(const agg::int8u* row, unsigned width, agg::int8u* indices) const
+{
+    agg::int64u last = 0;
+    int index = -1;
+    for (unsigned x = 0; x < width; ++x, row += mBytesPerPixel) {
+        agg::int64u pixel = pack(row, mBytesPerPixel);
+        if (index < 0 || pixel != last) {
+            index = find(pixel);
+            assert(index >= 0);
+            last = pixel;
+        }
+        indices[x] = static_cast<agg::int8u>(index);
+    }
+}
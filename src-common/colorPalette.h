@@ -0,0 +1,74 @@
+// colorPalette.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// The exact set of pixel values in a finished image, if there are few enough
+// of them to make a palette. Bands of rows are scanned in parallel and each
+// band gives up as soon as the image has too many colors.
+
+#ifndef INCLUDE_COLORPALETTE_H
+#define INCLUDE_COLORPALETTE_H
+
+#include "agg2/agg_basics.h"
+#include <vector>
+#include <algorithm>
+
+class colorPalette {
+public:
+    enum { MaxColors = 256 };
+
+    colorPalette(const agg::int8u* data, unsigned width, unsigned height, int stride,
+                 unsigned bytesPerPixel, unsigned maxColors = MaxColors);
+        // row y of the image starts at data + y * stride, stride can be negative
+
+    bool fits() const { return mFits; }
+        // whether there are at most maxColors distinct pixels
+    const std::vector<agg::int64u>& colors() const { return mColors; }
+        // the distinct pixels, in no particular order, empty if they don't fit
+
+    template <class Compare>
+    void sort(Compare comp)
+    {
+        std::stable_sort(mColors.begin(), mColors.end(), comp);
+        rehash();
+    }
+        // reorders the palette, comp compares the pixel values
+
+    void indexRow(const agg::int8u* row, unsigned width, agg::int8u* indices) const;
+        // palette index of each pixel in a row of the image
+
+    static agg::int64u pack(const agg::int8u* p, unsigned bytesPerPixel);
+    static void unpack(agg::int64u pixel, agg::int8u* p, unsigned bytesPerPixel);
+        // pixel bytes to and from a palette value
+
+private:
+    void rehash();
+    int find(agg::int64u pixel) const;
+
+    unsigned mBytesPerPixel;
+    bool mFits;
+    std::vector<agg::int64u> mColors;
+    std::vector<int> mSlots;    // hash of mColors, index or -1
+};
+
+#endif // INCLUDE_COLORPALETTE_H
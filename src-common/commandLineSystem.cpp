@@ -165,6 +165,20 @@ CommandLineSystem::stats(const Stats& s)
         
         if (s.toDoCount > 0)
             cerr << " - " << prettyInt(static_cast<unsigned long>(s.toDoCount)) << " expansions to do";
+        
+        if (s.culledCount > 0)
+            cerr << " - " << prettyInt(static_cast<unsigned long>(s.culledCount)) << " off canvas";
+        
+        if (s.batchedCount > 0)
+            cerr << " - " << prettyInt(static_cast<unsigned long>(s.batchedCount)) << " batched loop iterations";
+        
+        if (s.pathCount > 0)
+            cerr << " - " << prettyInt(static_cast<unsigned long>(s.pathCacheHits)) << " of "
+                 << prettyInt(static_cast<unsigned long>(s.pathCount)) << " paths cached";
+        
+        if (s.outputStall > 0.0)
+            cerr << " - " << prettyInt(static_cast<unsigned long>(s.outputStall * 1000.0))
+                 << " msec waiting for encoder";
     }
 
     clearAndCR();
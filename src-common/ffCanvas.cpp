@@ -28,6 +28,12 @@
 #include <cassert>
 #include <vector>
 #include <array>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstring>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
@@ -115,13 +121,18 @@ bool ffCanvas::Available()
 #endif
 
 class ffCanvas::Impl
+// Frames are copied into a small ring of buffers and converted and encoded
+// on a thread of their own, so the next frame can be drawn while the last
+// one is being encoded.
 {
 public:
     Impl(const char* name, PixelFormat fmt, int width, int height, int stride,
         int fps, QTcodec codec);
     ~Impl();
     
-    void addFrame(bool end);
+    void queueFrame();
+    void encode();
+    void addFrame(const char* data);    // nullptr flushes the encoder
     
     int             mWidth;
     int             mHeight;
@@ -129,7 +140,18 @@ public:
     std::vector<char> mBuffer;
     int             mFrameRate;
     int				mLineSize = 0;
-    const char*     mError = nullptr;
+    std::atomic<const char*> mError{nullptr};
+
+    static const std::size_t RingSize = 3;
+    std::array<std::vector<char>, RingSize> mRing;
+    std::size_t     mNext = 0;      // frames queued so far
+    std::size_t     mQueued = 0;    // frames waiting for or in the encoder
+    bool            mQuit = false;
+    double          mStallTime = 0.0;   // seconds waiting for a free buffer
+    std::mutex      mMutex;
+    std::condition_variable mFilled;
+    std::condition_variable mFreed;
+    std::thread     mEncoder;
     
     AVStream        *mStream = nullptr;
     AVCodecContext  *mEncCtx = nullptr;
@@ -265,12 +287,25 @@ ffCanvas::Impl::Impl(const char* name, PixelFormat fmt, int width, int height, i
         mError = "failed to write video file header";
         return;
     }
+    
+    for (auto&& buffer: mRing)
+        buffer.resize(mBuffer.size());
+    mEncoder = std::thread(&Impl::encode, this);
 }
 
 ffCanvas::Impl::~Impl()
 {
+    if (mEncoder.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQuit = true;
+        }
+        mFilled.notify_one();
+        mEncoder.join();        // after encoding the queued frames
+    }
+
     if (!mError) {
-        addFrame(true);         // flush out any packets
+        addFrame(nullptr);      // flush out any packets
         int ret = my_av_write_trailer(mOutputCtx);
         if (ret >= 0)
             ret = my_avio_close(mOutputCtx->pb);
@@ -296,19 +331,66 @@ ffCanvas::Impl::~Impl()
 }
 
 void
-ffCanvas::Impl::addFrame(bool end)
+ffCanvas::Impl::queueFrame()
+{
+    std::size_t slot;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        if (mQueued == RingSize) {
+            auto waitStart = std::chrono::steady_clock::now();
+            mFreed.wait(lock, [this]() { return mQueued < RingSize; });
+            std::chrono::duration<double> wait = std::chrono::steady_clock::now() - waitStart;
+            mStallTime += wait.count();
+        }
+        slot = mNext % RingSize;
+    }
+    
+    // The encoder is not using this buffer and the drawing buffer keeps
+    // the frame for animations that draw over the previous frame
+    std::memcpy(mRing[slot].data(), mBuffer.data(), mBuffer.size());
+    
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mNext;
+        ++mQueued;
+    }
+    mFilled.notify_one();
+}
+
+void
+ffCanvas::Impl::encode()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;) {
+        mFilled.wait(lock, [this]() { return mQuit || mQueued; });
+        if (!mQueued)
+            return;
+        std::size_t slot = (mNext - mQueued) % RingSize;
+        lock.unlock();
+        
+        if (!mError)
+            addFrame(mRing[slot].data());
+        
+        lock.lock();
+        --mQueued;
+        mFreed.notify_one();
+    }
+}
+
+void
+ffCanvas::Impl::addFrame(const char* data)
 {
-    AVFrame* frame = end ? nullptr : mFrame;
+    AVFrame* frame = data ? mFrame : nullptr;
     int ret;
     bool tryAgain = false;
 
-    if (!end) {
+    if (data) {
         if (my_av_frame_make_writable(frame)) {
             mError = "Error encoding frame";
             return;
         }
 
-        const uint8_t* src = (uint8_t*)(mBuffer.data());
+        const uint8_t* src = (const uint8_t*)(data);
         if (my_sws_scale(mSwsCtx, &src, &mLineSize, 0, mHeight, frame->data, frame->linesize) < mHeight)
             mError = "Error recoding frame";
         frame->pts = my_av_rescale_q(mEncCtx->frame_number, mEncCtx->time_base, mStream->time_base);
@@ -407,8 +489,9 @@ ffCanvas::end()
     aggCanvas::end();
 
     if (impl) {
-        impl->addFrame(false);
-        if (impl->mError) {
+        impl->queueFrame();
+        mStallTime = impl->mStallTime;
+        if (impl->mError) {         // reported a frame or so late
             mErrorMsg = impl->mError;
             mError = true;
             impl.reset();
@@ -0,0 +1,267 @@
+// frameJobs.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+#include "frameJobs.h"
+#include "aggCanvas.h"
+#include "CmdInfo.h"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace {
+    class recordingCanvas : public Canvas {
+    // Keeps the drawing calls of a frame so that they can be played back
+    // into another canvas
+    public:
+        recordingCanvas(int width, int height) : Canvas(width, height) {}
+
+        void start(bool clear, const agg::rgba& bk, int width, int height) override
+        {
+            Canvas::start(clear, bk, width, height);
+            mStarted = true;
+            mClear = clear;
+            mBackground = bk;
+            mCropWidth = width;
+            mCropHeight = height;
+        }
+
+        void primitive(int shape, RGBA8 c, agg::trans_affine tr, agg::comp_op_e blend) override
+        {
+            mOps.push_back({ shape, c, tr, blend, 0 });
+        }
+
+        void path(RGBA8 c, agg::trans_affine tr, const AST::CommandInfo& attr) override;
+
+        void play(Canvas& canvas) const;
+
+        bool started() const { return mStarted; }
+        void startOutput(Canvas& canvas) const
+            { canvas.start(mClear, mBackground, mCropWidth, mCropHeight); }
+
+    private:
+        struct Op {
+            int                 shape;      // primShape type or PathOp
+            RGBA8               color;
+            agg::trans_affine   transform;
+            agg::comp_op_e      blend;
+            std::size_t         info;       // index into mInfo for paths
+        };
+        enum { PathOp = -1 };
+
+        bool                mStarted = false;
+        bool                mClear = true;
+        agg::rgba           mBackground;
+        int                 mCropWidth = 0;
+        int                 mCropHeight = 0;
+        std::vector<Op>     mOps;
+        agg::path_storage   mPaths;
+        AST::InfoCache      mInfo;
+    };
+
+    void
+    recordingCanvas::path(RGBA8 c, agg::trans_affine tr, const AST::CommandInfo& attr)
+    {
+        // The renderer reuses its path storage, so the path is copied
+        unsigned index = mPaths.start_new_path();
+        double x, y;
+        unsigned cmd;
+        attr.mPath->rewind(attr.mIndex);
+        while (!agg::is_stop(cmd = attr.mPath->vertex(&x, &y)))
+            mPaths.vertices().add_vertex(x, y, cmd);
+
+        mInfo.emplace_back(attr);
+        mInfo.back().mPath = &mPaths;
+        mInfo.back().mIndex = index;
+        mInfo.back().mPathUID = 0;         // not the path that the UID names
+        mOps.push_back({ PathOp, c, tr, agg::comp_op_src_over, mInfo.size() - 1 });
+    }
+
+    void
+    recordingCanvas::play(Canvas& canvas) const
+    {
+        startOutput(canvas);
+        for (const Op& op: mOps) {
+            if (op.shape == PathOp)
+                canvas.path(op.color, op.transform, mInfo[op.info]);
+            else
+                canvas.primitive(op.shape, op.color, op.transform, op.blend);
+        }
+        canvas.end();
+    }
+
+    class frameCanvas : public aggCanvas {
+    // An aggCanvas with a pixel buffer of its own
+    public:
+        frameCanvas(PixelFormat pixfmt, int width, int height)
+        : aggCanvas(pixfmt)
+        {
+            int stride = width * BytesPerPixel.at(static_cast<PixelFormat>(pixfmt & ~Has_Float_Accum));
+            mData.resize(static_cast<std::size_t>(stride) * height);
+            attach(mData.data(), width, height, stride);
+        }
+
+    private:
+        std::vector<agg::int8u> mData;
+    };
+}
+
+class frameJobs::impl {
+public:
+    struct Frame {
+        recordingCanvas recording;
+        std::unique_ptr<frameCanvas> image;
+        bool done = false;
+
+        Frame(int width, int height) : recording(width, height) {}
+    };
+
+    impl(aggCanvas* output, int jobs);
+    ~impl();
+
+    void work();
+    void writeOldest(std::unique_lock<std::mutex>& lock);
+
+    aggCanvas*                          mOutput;
+    std::size_t                         mWindow;    // most frames in memory
+    std::unique_ptr<Frame>              mDrawing;   // between next() and submit()
+    std::deque<std::unique_ptr<Frame>>  mFrames;    // submitted, oldest first
+    std::deque<Frame*>                  mQueue;     // waiting for a worker
+    std::vector<std::unique_ptr<frameCanvas>>
+                                        mSpare;     // images of written frames
+    std::mutex                          mMutex;
+    std::condition_variable             mWork;
+    std::condition_variable             mDone;
+    bool                                mQuit = false;
+    std::vector<std::thread>            mWorkers;
+};
+
+frameJobs::impl::impl(aggCanvas* output, int jobs)
+: mOutput(output), mWindow(2 * static_cast<std::size_t>(jobs))
+{
+    for (int i = 0; i < jobs; ++i)
+        mWorkers.emplace_back(&impl::work, this);
+}
+
+frameJobs::impl::~impl()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+        mQueue.clear();
+    }
+    mWork.notify_all();
+    for (auto&& worker: mWorkers)
+        worker.join();
+}
+
+void
+frameJobs::impl::work()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    for (;;) {
+        mWork.wait(lock, [this]() { return mQuit || !mQueue.empty(); });
+        if (mQuit)
+            return;
+        Frame* frame = mQueue.front();
+        mQueue.pop_front();
+        std::unique_ptr<frameCanvas> image;
+        if (!mSpare.empty()) {
+            image = std::move(mSpare.back());
+            mSpare.pop_back();
+        }
+        lock.unlock();
+
+        if (!image)
+            image = std::make_unique<frameCanvas>(mOutput->pixelFormat(),
+                                                  mOutput->mWidth, mOutput->mHeight);
+        if (frame->recording.started())
+            frame->recording.play(*image);
+
+        lock.lock();
+        frame->image = std::move(image);
+        frame->done = true;
+        mDone.notify_all();
+    }
+}
+
+void
+frameJobs::impl::writeOldest(std::unique_lock<std::mutex>& lock)
+{
+    Frame& frame = *mFrames.front();
+    mDone.wait(lock, [&frame]() { return frame.done; });
+    lock.unlock();
+
+    // A frame that was stopped before it started drawing is not written
+    if (frame.recording.started()) {
+        frame.recording.startOutput(*mOutput);
+        mOutput->draw(*frame.image, 0, 0);
+        mOutput->end();
+    }
+
+    lock.lock();
+    mSpare.push_back(std::move(frame.image));
+    mFrames.pop_front();
+}
+
+frameJobs::frameJobs(aggCanvas* output, int jobs)
+: m(std::make_unique<impl>(output, jobs))
+{ }
+
+frameJobs::~frameJobs() = default;
+
+Canvas*
+frameJobs::next()
+{
+    std::unique_lock<std::mutex> lock(m->mMutex);
+    while (!m->mFrames.empty() &&
+           (m->mFrames.front()->done || m->mFrames.size() >= m->mWindow))
+    {
+        m->writeOldest(lock);
+    }
+    m->mDrawing = std::make_unique<impl::Frame>(m->mOutput->mWidth, m->mOutput->mHeight);
+    return &m->mDrawing->recording;
+}
+
+void
+frameJobs::submit()
+{
+    if (!m->mDrawing)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m->mMutex);
+        m->mQueue.push_back(m->mDrawing.get());
+        m->mFrames.push_back(std::move(m->mDrawing));
+    }
+    m->mWork.notify_one();
+}
+
+void
+frameJobs::finish()
+{
+    std::unique_lock<std::mutex> lock(m->mMutex);
+    while (!m->mFrames.empty())
+        m->writeOldest(lock);
+}
@@ -0,0 +1,59 @@
+// frameJobs.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// Rasterizes animation frames on several threads at once. The renderer
+// draws each frame into a canvas that records the drawing calls and worker
+// threads play the recordings back into canvases of their own. Finished
+// frames are copied to the output canvas in frame order. The renderer is
+// held up once it gets a few frames ahead of the output, so only a bounded
+// number of frames are in memory.
+
+#ifndef INCLUDE_FRAMEJOBS_H
+#define INCLUDE_FRAMEJOBS_H
+
+#include <memory>
+
+class Canvas;
+class aggCanvas;
+
+class frameJobs {
+public:
+    frameJobs(aggCanvas* output, int jobs);
+    ~frameJobs();
+    frameJobs& operator=(const frameJobs&) = delete;
+
+    Canvas* next();
+        // canvas to draw the next frame into, finished frames may be
+        // written out while waiting for room
+    void submit();
+        // queue the frame drawn since next() for rasterizing
+    void finish();
+        // wait for the queued frames and write them out
+
+private:
+    class impl;
+    std::unique_ptr<impl> m;
+};
+
+#endif // INCLUDE_FRAMEJOBS_H
@@ -27,15 +27,146 @@
 #include "ast.h"
 #include "CmdInfo.h"
 #include "primShape.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <list>
+#include <unordered_map>
 
 static primShape dummy;
 
+namespace {
+    // Andrew's monotone chain. Collinear points on the hull are kept so
+    // that no point that could be extreme after rounding is dropped.
+    std::vector<agg::point_d>
+    convexHull(std::vector<agg::point_d>& pts)
+    {
+        std::sort(pts.begin(), pts.end(), [](const agg::point_d& a, const agg::point_d& b) {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+        pts.erase(std::unique(pts.begin(), pts.end(), [](const agg::point_d& a, const agg::point_d& b) {
+            return a.x == b.x && a.y == b.y;
+        }), pts.end());
+        if (pts.size() < 3)
+            return pts;
+        
+        auto cross = [](const agg::point_d& o, const agg::point_d& a, const agg::point_d& b) {
+            return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+        };
+        std::vector<agg::point_d> hull(2 * pts.size());
+        std::size_t k = 0;
+        for (std::size_t i = 0; i < pts.size(); ++i) {
+            while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) < 0.0) --k;
+            hull[k++] = pts[i];
+        }
+        for (std::size_t i = pts.size() - 1, t = k + 1; i-- > 0; ) {
+            while (k >= t && cross(hull[k - 2], hull[k - 1], pts[i]) < 0.0) --k;
+            hull[k++] = pts[i];
+        }
+        hull.resize(k - 1);
+        return hull;
+    }
+}
+
+class pathIterator::StrokeCache
+// Strokes that are not CF_ISO_WIDTH are made in path-local space and then
+// transformed, so instances of a path command that are drawn at the same
+// scale get the same stroke. The stroke is kept for each command and scale,
+// and replayed through a transform. A stroke is only kept the second time
+// that it is asked for, so paths that are drawn once don't fill the cache.
+{
+public:
+    enum consts_t : std::size_t { Capacity = 256 };
+    
+    struct Stroke {
+        std::vector<agg::point_d>   mVertices;
+        std::vector<unsigned>       mCommands;
+        std::size_t                 mNext = 0;
+        bool                        mBuilt = false;
+        
+        void rewind(unsigned) { mNext = 0; }
+        unsigned vertex(double* x, double* y)
+        {
+            if (mNext >= mCommands.size())
+                return agg::path_cmd_stop;
+            *x = mVertices[mNext].x;
+            *y = mVertices[mNext].y;
+            return mCommands[mNext++];
+        }
+    };
+    using StrokeTrans = agg::conv_transform<Stroke, const agg::trans_affine>;
+    
+    Stroke* find(const AST::CommandInfo& attr, double scale, bool cusps);
+        // returns the stroke of attr at scale, or nullptr if it has not been
+        // asked for before; a returned stroke may still need to be built
+    
+private:
+    struct Key {
+        AST::UIDdatatype    mPathUID;
+        unsigned            mIndex;
+        int                 mFlags;
+        double              mStrokeWidth;
+        double              mMiterLimit;
+        double              mScale;         // rounded to 40 bits
+        bool                mCusps;
+        
+        bool operator==(const Key& o) const
+        {
+            return mPathUID == o.mPathUID && mIndex == o.mIndex &&
+                   mFlags == o.mFlags && mStrokeWidth == o.mStrokeWidth &&
+                   mMiterLimit == o.mMiterLimit && mScale == o.mScale &&
+                   mCusps == o.mCusps;
+        }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const
+        {
+            std::size_t h = std::hash<AST::UIDdatatype>()(k.mPathUID);
+            h = h * 31 + k.mIndex;
+            return h * 31 + std::hash<double>()(k.mScale);
+        }
+    };
+    using Entry = std::pair<Key, Stroke>;
+    
+    std::list<Entry> mEntries;          // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> mIndex;
+};
+
+pathIterator::StrokeCache::Stroke*
+pathIterator::StrokeCache::find(const AST::CommandInfo& attr, double scale,
+                                bool cusps)
+{
+    // The scale comes from the determinant of the transform, which rounds
+    // differently for rotated copies of the same shape
+    int exp;
+    double mantissa = std::frexp(scale, &exp);
+    Key key{attr.mPathUID, attr.mIndex, attr.mFlags, attr.mStrokeWidth,
+            attr.mMiterLimit, std::ldexp(std::round(std::ldexp(mantissa, 40)), exp - 40),
+            cusps};
+    
+    auto found = mIndex.find(key);
+    if (found != mIndex.end()) {
+        mEntries.splice(mEntries.begin(), mEntries, found->second);
+        return &found->second->second;
+    }
+    
+    if (mEntries.size() >= Capacity) {
+        mIndex.erase(mEntries.back().first);
+        mEntries.pop_back();
+    }
+    mEntries.emplace_front(key, Stroke());
+    mIndex.emplace(key, mEntries.begin());
+    return nullptr;
+}
+
 pathIterator::pathIterator() 
 : curved(dummy), 
   curvedStroked(curved), curvedStrokedTrans(curvedStroked, unitTrans),
   curvedTrans(curved, unitTrans), curvedTransStroked(curvedTrans)
 { }
 
+pathIterator::~pathIterator() = default;
+
 void
 pathIterator::apply(const AST::CommandInfo& attr, 
                     const agg::trans_affine& tr, 
@@ -104,7 +235,30 @@ pathIterator::addPath<agg::rasterizer_scanline_aa<> >(agg::rasterizer_scanline_a
         if (attr.mFlags & AST::CF_ISO_WIDTH) {
             ras.add_path(curvedTransStroked, attr.mIndex);
         } else {
-            ras.add_path(curvedStrokedTrans, attr.mIndex);
+            double scale = sqrt(fabs(tr.determinant()));
+            StrokeCache::Stroke* stroke = nullptr;
+            if (attr.mPathUID != 0 && attr.mPathUID != AST::CommandInfo::PathUIDDefault &&
+                scale > 0.0 && std::isfinite(scale))
+            {
+                if (!mStrokes)
+                    mStrokes = std::make_unique<StrokeCache>();
+                stroke = mStrokes->find(attr, scale, attr.mStrokeWidth * scale > 1.0);
+            }
+            if (!stroke) {
+                ras.add_path(curvedStrokedTrans, attr.mIndex);
+                return;
+            }
+            if (!stroke->mBuilt) {
+                curvedStroked.rewind(attr.mIndex);
+                double x, y;
+                for (unsigned cmd; !agg::is_stop(cmd = curvedStroked.vertex(&x, &y)); ) {
+                    stroke->mVertices.emplace_back(x, y);
+                    stroke->mCommands.push_back(cmd);
+                }
+                stroke->mBuilt = true;
+            }
+            StrokeCache::StrokeTrans strokeTrans(*stroke, tr);
+            ras.add_path(strokeTrans);
         }
     }
 }
@@ -132,3 +286,43 @@ pathIterator::boundingRect(const agg::trans_affine& tr,
     return ret;
 }
 
+const std::vector<agg::point_d>&
+pathIterator::localHull(const agg::trans_affine& tr, const AST::CommandInfo& attr,
+                        double scale)
+{
+    // Flatten the way boundingRect() does: the extremes of the transformed
+    // hull are then the transformed extremes that boundingRect() finds
+    apply(attr, tr, scale * 0.1);
+    double accuracy = curved.approximation_scale();
+    double angle = curved.angle_tolerance();
+    
+    // The accuracy comes from the determinant of tr, which rounds differently
+    // for rotated copies of the same shape
+    if (attr.mHull && attr.mHull->mPathUID == attr.mPathUID &&
+                      attr.mHull->mFlags == attr.mFlags &&
+                      std::fabs(attr.mHull->mAccuracy - accuracy) <= accuracy * 1e-12 &&
+                      attr.mHull->mAngleTolerance == angle)
+        return attr.mHull->mPoints;
+    
+    std::vector<agg::point_d> pts;
+    auto gather = [&pts, &attr](auto& source) {
+        source.rewind(attr.mIndex);
+        double x, y;
+        for (unsigned cmd; !agg::is_stop(cmd = source.vertex(&x, &y)); )
+            if (agg::is_vertex(cmd))
+                pts.emplace_back(x, y);
+    };
+    if (attr.mFlags & AST::CF_FILL)
+        gather(curved);
+    else
+        gather(curvedStroked);
+    
+    auto hull = std::make_shared<AST::CommandInfo::Hull>();
+    hull->mPathUID = attr.mPathUID;
+    hull->mFlags = attr.mFlags;
+    hull->mAccuracy = accuracy;
+    hull->mAngleTolerance = angle;
+    hull->mPoints = convexHull(pts);
+    attr.mHull = std::move(hull);
+    return attr.mHull->mPoints;
+}
@@ -32,6 +32,8 @@
 #include "agg2/agg_conv_curve.h"
 #include "agg2/agg_trans_affine.h"
 #include "agg2/agg_path_storage.h"
+#include <memory>
+#include <vector>
 
 namespace AST {
     struct CommandInfo;
@@ -53,7 +55,7 @@ public:
     CurvedTransStroked  curvedTransStroked;
     
     pathIterator();
-    ~pathIterator() = default;
+    ~pathIterator();
     
     void apply(const AST::CommandInfo& attr, const agg::trans_affine& tr, 
                double accuracy);
@@ -63,6 +65,18 @@ public:
     bool boundingRect(const agg::trans_affine& tr, const AST::CommandInfo& attr,
                       double& minx, double& miny, double& maxx, double& maxy,
                       double scale);
+    const std::vector<agg::point_d>& localHull(const agg::trans_affine& tr,
+                                               const AST::CommandInfo& attr,
+                                               double scale);
+        // The convex hull of the filled or stroked path before transformation,
+        // flattened as boundingRect() would flatten it and cached in attr.
+        // Not valid for CF_ISO_WIDTH strokes, which are stroked after
+        // transformation.
+private:
+    class StrokeCache;
+    std::unique_ptr<StrokeCache> mStrokes;
+        // strokes of cached paths that are drawn more than once, created on
+        // first use by addPath()
 };
 
 #endif
@@ -24,7 +24,17 @@
 
 #include "primShape.h"
 #include <cmath>
+#include <algorithm>
 #include "agg2/agg_basics.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#endif
+#include "agg2/agg_conv_stroke.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#include "ast.h"
 
 using namespace agg;
 
@@ -65,6 +75,73 @@ const primShape::primNames_t primShape::shapeNames = {
     { "CIRCLE", "SQUARE", "TRIANGLE", "FILL" }
 };
 
+void
+primShape::setOutline()
+{
+    // Stroke it the way pathIterator strokes a default CommandInfo. The
+    // stroke of a closed convex polygon is an outer contour around an inner
+    // one; only the outer contour can be extreme. The miter joins on the
+    // outside do not depend on the approximation scale.
+    conv_stroke<path_storage> stroke(*this);
+    stroke.width(AST::DefaultStrokeWidth);
+    stroke.line_join(miter_join);
+    stroke.line_cap(butt_cap);
+    stroke.miter_limit(AST::DefaultMiterLimit);
+    stroke.inner_join(inner_round);
+    
+    std::vector<point_d> contour;
+    double outerExtent = -1.0;
+    auto endContour = [&]() {
+        if (contour.empty()) return;
+        double minx = contour.front().x, maxx = minx;
+        double miny = contour.front().y, maxy = miny;
+        for (auto&& p: contour) {
+            minx = std::min(minx, p.x); maxx = std::max(maxx, p.x);
+            miny = std::min(miny, p.y); maxy = std::max(maxy, p.y);
+        }
+        double extent = (maxx - minx) * (maxy - miny);
+        if (extent > outerExtent) {
+            outerExtent = extent;
+            mOutline.swap(contour);
+        }
+        contour.clear();
+    };
+    
+    stroke.rewind(0);
+    double x, y;
+    for (unsigned cmd; !is_stop(cmd = stroke.vertex(&x, &y)); ) {
+        if (is_move_to(cmd))
+            endContour();
+        if (is_vertex(cmd))
+            contour.emplace_back(x, y);
+    }
+    endContour();
+}
+
+bool
+primShape::boundingRect(const trans_affine& tr, double& minx, double& miny,
+                        double& maxx, double& maxy) const
+{
+    minx = miny = 1.0;
+    maxx = maxy = 0.0;
+    bool first = true;
+    for (point_d p: mOutline) {
+        tr.transform(&p.x, &p.y);
+        double x = p.x, y = p.y;
+        if (first) {
+            minx = maxx = x;
+            miny = maxy = y;
+            first = false;
+        } else {
+            if (x < minx) minx = x;
+            if (y < miny) miny = y;
+            if (x > maxx) maxx = x;
+            if (y > maxy) maxy = y;
+        }
+    }
+    return minx <= maxx && miny <= maxy;
+}
+
 unsigned
 primIter::vertex(double* x, double* y)
 {
@@ -31,6 +31,7 @@
 #include <cassert>
 #include <string>
 #include <array>
+#include <vector>
 
 class primShape : public agg::path_storage
 {
@@ -47,12 +48,26 @@ public:
         for (++p; p != l.end(); ++p)
             line_to(p->first, p->second);
         end_poly(agg::path_flags_close);
+        setOutline();
     }
     primShape() = default;
     
+    bool boundingRect(const agg::trans_affine& tr, double& minx, double& miny,
+                      double& maxx, double& maxy) const;
+        // The bounds of the transformed shape with the default stroke, which
+        // is how the renderer bounds primitives. The same result as running
+        // it through agg::conv_stroke, agg::conv_transform and
+        // agg::bounding_rect_single, but only the outline is transformed.
+    
     static const primShapes_t shapeMap;
     static const primNames_t shapeNames;
     static bool isPrimShape(unsigned v) { return v < numTypes; }
+    
+private:
+    std::vector<agg::point_d> mOutline;
+        // outer contour of the shape with the default stroke, it does not
+        // depend on the transform because the stroke is in shape space
+    void setOutline();
 };
 
 class primIter
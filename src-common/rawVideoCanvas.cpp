@@ -0,0 +1,353 @@
+// rawVideoCanvas.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+#include "rawVideoCanvas.h"
+#include "makeCFfilename.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RAWVIDEO_SSE2 1
+#endif
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+using std::cerr;
+using std::endl;
+
+namespace {
+    // BT.601 studio range, 8 fractional bits
+    const int YCoef[3]  = {  66, 129,  25 };
+    const int CbCoef[3] = { -38, -74, 112 };
+    const int CrCoef[3] = { 112, -94, -18 };
+
+    inline unsigned char
+    clamp8(int v)
+    {
+        return static_cast<unsigned char>(v < 0 ? 0 : v > 255 ? 255 : v);
+    }
+
+    inline unsigned char
+    lumaOf(const unsigned char* p)
+    {
+        return clamp8(((YCoef[0] * p[0] + YCoef[1] * p[1] + YCoef[2] * p[2] + 128) >> 8) + 16);
+    }
+
+    inline unsigned char
+    chromaOf(const unsigned char* p, const int* coef)
+    {
+        return clamp8(((coef[0] * p[0] + coef[1] * p[1] + coef[2] * p[2] + 128) >> 8) + 128);
+    }
+
+    inline unsigned char
+    to8(agg::int16u v)
+    // Rounded, so that 16-bit renders are not biased dark
+    {
+        return static_cast<unsigned char>((v * 255 + 32895) >> 16);
+    }
+
+    inline unsigned char
+    avg(unsigned char a, unsigned char b)
+    {
+        return static_cast<unsigned char>((a + b + 1) >> 1);
+    }
+
+    void
+    average2x2(const unsigned char* a0, const unsigned char* a1,
+               const unsigned char* b0, const unsigned char* b1, unsigned char* out)
+    // Same rounding as the SIMD version: rows first, then columns
+    {
+        for (int i = 0; i < 3; ++i)
+            out[i] = avg(avg(a0[i], b0[i]), avg(a1[i], b1[i]));
+    }
+
+#ifdef RAWVIDEO_SSE2
+    inline __m128i
+    weighSums(__m128i px, __m128i coef)
+    // Four RGBA8 pixels in, the four 32-bit weighted sums of their RGB out
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi8(px, zero), coef);
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi8(px, zero), coef);
+        __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi),
+                                     _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 odd  = _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi),
+                                     _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    inline __m128i
+    scaleSums(__m128i sums, int offset)
+    {
+        sums = _mm_srai_epi32(_mm_add_epi32(sums, _mm_set1_epi32(128)), 8);
+        return _mm_add_epi32(sums, _mm_set1_epi32(offset));
+    }
+
+    inline __m128i
+    coefficients(const int* coef)
+    {
+        return _mm_setr_epi16(static_cast<short>(coef[0]), static_cast<short>(coef[1]),
+                              static_cast<short>(coef[2]), 0,
+                              static_cast<short>(coef[0]), static_cast<short>(coef[1]),
+                              static_cast<short>(coef[2]), 0);
+    }
+#endif
+
+    void
+    lumaRow(const unsigned char* rgba, int width, unsigned char* y)
+    {
+        int x = 0;
+#ifdef RAWVIDEO_SSE2
+        const __m128i coef = coefficients(YCoef);
+        for (; x + 8 <= width; x += 8) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + 4 * x));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + 4 * x + 16));
+            __m128i w = _mm_packs_epi32(scaleSums(weighSums(a, coef), 16),
+                                        scaleSums(weighSums(b, coef), 16));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(y + x), _mm_packus_epi16(w, w));
+        }
+#endif
+        for (; x < width; ++x)
+            y[x] = lumaOf(rgba + 4 * x);
+    }
+
+    void
+    chromaRow(const unsigned char* rowA, const unsigned char* rowB, int width,
+              unsigned char* cb, unsigned char* cr)
+    // Each chroma sample is the average of a 2x2 block. An odd last column
+    // is averaged with itself, as is an odd last row (rowB == rowA).
+    {
+        int x = 0;
+#ifdef RAWVIDEO_SSE2
+        const __m128i cbCoef = coefficients(CbCoef);
+        const __m128i crCoef = coefficients(CrCoef);
+        for (; x + 8 <= width; x += 8) {
+            const __m128i* a = reinterpret_cast<const __m128i*>(rowA + 4 * x);
+            const __m128i* b = reinterpret_cast<const __m128i*>(rowB + 4 * x);
+            __m128i v0 = _mm_avg_epu8(_mm_loadu_si128(a), _mm_loadu_si128(b));
+            __m128i v1 = _mm_avg_epu8(_mm_loadu_si128(a + 1), _mm_loadu_si128(b + 1));
+            v0 = _mm_avg_epu8(v0, _mm_srli_epi64(v0, 32));
+            v1 = _mm_avg_epu8(v1, _mm_srli_epi64(v1, 32));
+            __m128i px = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(v0),
+                                                         _mm_castsi128_ps(v1),
+                                                         _MM_SHUFFLE(2, 0, 2, 0)));
+            __m128i c = _mm_packs_epi32(scaleSums(weighSums(px, cbCoef), 128),
+                                        scaleSums(weighSums(px, crCoef), 128));
+            c = _mm_packus_epi16(c, c);
+            std::int32_t cbs = _mm_cvtsi128_si32(c);
+            std::int32_t crs = _mm_cvtsi128_si32(_mm_srli_si128(c, 4));
+            std::memcpy(cb + x / 2, &cbs, 4);
+            std::memcpy(cr + x / 2, &crs, 4);
+        }
+#endif
+        for (; x < width; x += 2) {
+            int x1 = x + 1 < width ? x + 1 : x;
+            unsigned char p[3];
+            average2x2(rowA + 4 * x, rowA + 4 * x1, rowB + 4 * x, rowB + 4 * x1, p);
+            cb[x / 2] = chromaOf(p, CbCoef);
+            cr[x / 2] = chromaOf(p, CrCoef);
+        }
+    }
+}
+
+void
+rawVideoCanvas::FileCloser::operator()(std::FILE* f) const
+{
+    if (f == stdout)
+        std::fflush(f);
+    else
+        std::fclose(f);
+}
+
+rawVideoCanvas::rawVideoCanvas(const char* outfilename, bool quiet, int width, int height,
+                               PixelFormat pixfmt, int frameCount, int variation,
+                               Renderer* r, int fps, VideoFormat format)
+: abstractPngCanvas(outfilename, quiet, width, height, pixfmt, false, frameCount,
+                    variation, false, r, 1, 1),
+  mFormat(format), mFrameRate(fps)
+{
+    mFileName = makeCFfilename(outfilename, 0, 0, variation);
+    if (!mFileName.empty()) {
+        mOut.reset(std::fopen(mFileName.c_str(), "wb"));
+    } else {
+        mOut.reset(stdout);
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+    if (!mOut) {
+        mErrorMsg = "could not open video file";
+        mError = true;
+        return;
+    }
+
+    if (mFormat == Y4M) {
+        bool gray = (mPixelFormat & ~Has_16bit_Color) == Gray8_Blend;
+        std::fprintf(mOut.get(), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 %s\n",
+                     mWidth, mHeight, mFrameRate, gray ? "Cmono" : "C420jpeg");
+        int chroma = gray ? 0 : 2 * ((mWidth + 1) / 2) * ((mHeight + 1) / 2);
+        mFrame.resize(static_cast<std::size_t>(mWidth) * mHeight + chroma);
+    } else {
+        mFrame.resize(static_cast<std::size_t>(mWidth) * mHeight * 4);
+    }
+    mRow.resize(2 * static_cast<std::size_t>(mWidth) * 4);
+}
+
+rawVideoCanvas::~rawVideoCanvas() = default;
+
+void
+rawVideoCanvas::output(const char*, int)
+{
+    if (!mOut)
+        return;
+
+    if (mFormat == Y4M)
+        writeY4M();
+    else
+        writeRGBA();
+
+    if (std::ferror(mOut.get())) {
+        cerr << "Error writing video stream" << endl;
+        mError = true;
+        mOut.reset();
+    }
+}
+
+const unsigned char*
+rawVideoCanvas::rowRGBA8(int y, unsigned char* buf) const
+// Premultiplied RGBA8 for one row, in place if the canvas already is
+{
+    using RGBA = aggCanvas::RGBAOrder;
+    using RGB  = aggCanvas::RGBOrder;
+    const unsigned char* row = mData.data() + static_cast<std::size_t>(y) * mStride;
+    const agg::int16u* row16 = reinterpret_cast<const agg::int16u*>(row);
+    switch (mPixelFormat) {
+        case RGBA8_Blend:
+        case RGBA8_Custom_Blend:
+            if (std::is_same<RGBA, agg::order_rgba>::value)
+                return row;
+            for (int x = 0; x < mWidth; ++x) {
+                buf[4 * x + 0] = row[4 * x + RGBA::R];
+                buf[4 * x + 1] = row[4 * x + RGBA::G];
+                buf[4 * x + 2] = row[4 * x + RGBA::B];
+                buf[4 * x + 3] = row[4 * x + RGBA::A];
+            }
+            return buf;
+        case RGB8_Blend:
+            for (int x = 0; x < mWidth; ++x) {
+                buf[4 * x + 0] = row[3 * x + RGB::R];
+                buf[4 * x + 1] = row[3 * x + RGB::G];
+                buf[4 * x + 2] = row[3 * x + RGB::B];
+                buf[4 * x + 3] = 255;
+            }
+            return buf;
+        case RGBA16_Blend:
+        case RGBA16_Custom_Blend:
+            for (int x = 0; x < mWidth; ++x) {
+                buf[4 * x + 0] = to8(row16[4 * x + RGBA::R]);
+                buf[4 * x + 1] = to8(row16[4 * x + RGBA::G]);
+                buf[4 * x + 2] = to8(row16[4 * x + RGBA::B]);
+                buf[4 * x + 3] = to8(row16[4 * x + RGBA::A]);
+            }
+            return buf;
+        case RGB16_Blend:
+            for (int x = 0; x < mWidth; ++x) {
+                buf[4 * x + 0] = to8(row16[3 * x + RGB::R]);
+                buf[4 * x + 1] = to8(row16[3 * x + RGB::G]);
+                buf[4 * x + 2] = to8(row16[3 * x + RGB::B]);
+                buf[4 * x + 3] = 255;
+            }
+            return buf;
+        case Gray8_Blend:
+        case Gray16_Blend:
+            for (int x = 0; x < mWidth; ++x) {
+                unsigned char v = mPixelFormat == Gray8_Blend ? row[x] : to8(row16[x]);
+                buf[4 * x] = buf[4 * x + 1] = buf[4 * x + 2] = v;
+                buf[4 * x + 3] = 255;
+            }
+            return buf;
+        default:
+            std::memset(buf, 0, static_cast<std::size_t>(mWidth) * 4);
+            return buf;
+    }
+}
+
+void
+rawVideoCanvas::writeY4M()
+{
+    unsigned char* yPlane = mFrame.data();
+    std::size_t size = static_cast<std::size_t>(mWidth) * mHeight;
+
+    if ((mPixelFormat & ~Has_16bit_Color) == Gray8_Blend) {
+        // Gray is already luma, only the range changes
+        for (int y = 0; y < mHeight; ++y) {
+            const unsigned char* row = rowRGBA8(y, mRow.data());
+            for (int x = 0; x < mWidth; ++x)
+                yPlane[y * mWidth + x] = static_cast<unsigned char>(16 + (row[4 * x] * 219 + 127) / 255);
+        }
+    } else {
+        int chromaWidth = (mWidth + 1) / 2;
+        unsigned char* cbPlane = yPlane + size;
+        unsigned char* crPlane = cbPlane + static_cast<std::size_t>(chromaWidth) * ((mHeight + 1) / 2);
+        unsigned char* bufA = mRow.data();
+        unsigned char* bufB = bufA + static_cast<std::size_t>(mWidth) * 4;
+        for (int y = 0; y < mHeight; y += 2) {
+            const unsigned char* rowA = rowRGBA8(y, bufA);
+            const unsigned char* rowB = y + 1 < mHeight ? rowRGBA8(y + 1, bufB) : rowA;
+            lumaRow(rowA, mWidth, yPlane + static_cast<std::size_t>(y) * mWidth);
+            if (rowB != rowA)
+                lumaRow(rowB, mWidth, yPlane + static_cast<std::size_t>(y + 1) * mWidth);
+            std::size_t c = static_cast<std::size_t>(y / 2) * chromaWidth;
+            chromaRow(rowA, rowB, mWidth, cbPlane + c, crPlane + c);
+        }
+    }
+
+    std::fputs("FRAME\n", mOut.get());
+    std::fwrite(mFrame.data(), 1, mFrame.size(), mOut.get());
+}
+
+void
+rawVideoCanvas::writeRGBA()
+{
+    for (int y = 0; y < mHeight; ++y) {
+        const unsigned char* row = rowRGBA8(y, mRow.data());
+        unsigned char* out = mFrame.data() + static_cast<std::size_t>(y) * mWidth * 4;
+        for (int x = 0; x < mWidth * 4; x += 4) {
+            agg::rgba8 pix(row[x + 0], row[x + 1], row[x + 2], row[x + 3]);
+            pix.demultiply();
+            out[x + 0] = pix.r;
+            out[x + 1] = pix.g;
+            out[x + 2] = pix.b;
+            out[x + 3] = pix.a;
+        }
+    }
+    std::fwrite(mFrame.data(), 1, mFrame.size(), mOut.get());
+}
@@ -0,0 +1,69 @@
+// rawVideoCanvas.h
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// Streams animation frames into one file, or stdout, as uncompressed video
+// that an external encoder can read from a pipe. YUV4MPEG2 output is 4:2:0
+// with BT.601 studio range (mono for gray-scale designs), translucent pixels
+// are composited over black. Raw output is non-premultiplied 8-bit RGBA
+// with no header.
+
+#ifndef INCLUDE_RAWVIDEOCANVAS_H
+#define INCLUDE_RAWVIDEOCANVAS_H
+
+#include "abstractPngCanvas.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+class rawVideoCanvas : public abstractPngCanvas {
+public:
+    enum VideoFormat { Y4M = 0, RawRGBA = 1 };
+    rawVideoCanvas(const char* outfilename, bool quiet, int width, int height,
+                   PixelFormat pixfmt, int frameCount, int variation,
+                   Renderer* r, int fps, VideoFormat format);
+        // outfilename must outlive the canvas, "-" is stdout
+    ~rawVideoCanvas() override;
+    rawVideoCanvas& operator=(const rawVideoCanvas&) = delete;
+
+    const char* mErrorMsg = nullptr;
+
+protected:
+    void output(const char* outfilename, int frame = -1) override;
+
+private:
+    struct FileCloser {
+        void operator()(std::FILE* f) const;
+    };
+    std::unique_ptr<std::FILE, FileCloser> mOut;
+    VideoFormat mFormat;
+    int mFrameRate;
+    std::vector<unsigned char> mFrame;  // planes or rows to be written
+    std::vector<unsigned char> mRow;    // RGBA8 version of a row
+
+    void writeY4M();
+    void writeRGBA();
+    const unsigned char* rowRGBA8(int y, unsigned char* buf) const;
+};
+
+#endif // INCLUDE_RAWVIDEOCANVAS_H
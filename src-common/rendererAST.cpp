@@ -57,14 +57,16 @@ RendererAST::init()
 bool
 RendererAST::isNatural(RendererAST* r, double n)
 {
-    if (r && r->mImpure) return true;
+    // A renderer never runs while its design's builder is alive
+    if (r)
+        return r->mImpure || (n >= 0 && n <= r->mMaxNatural && n == std::floor(n));
 
     std::lock_guard<std::recursive_mutex> lock(Builder::BuilderMutex);
     
     if (Builder::CurrentBuilder &&
         Builder::CurrentBuilder->isMyBuilder() &&
         Builder::CurrentBuilder->impure()) return true;
-    return n >= 0 && n <= (r ? r->mMaxNatural : Builder::MaxNatural) && n == std::floor(n);
+    return n >= 0 && n <= Builder::MaxNatural && n == std::floor(n);
 }
 
 void
@@ -49,6 +49,10 @@ public:
         double      mMaxNatural = 1000.0;
         bool        mImpure = false;
 
+        int         mBatchedCount = 0;  // loop iterations expanded in batches
+        int         mPathCount = 0;     // path rules traversed
+        int         mPathCacheHits = 0; // ... that reused a compiled path
+
         double      mCurrentTime = 0.0;
         double      mCurrentFrame = 0.0;
         
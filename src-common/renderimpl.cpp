@@ -36,7 +36,11 @@
 #include <cassert>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <array>
+#include <unordered_map>
+#include <cstring>
+#include <mutex>
 
 #include <cmath>
 using std::isfinite;
@@ -47,6 +51,8 @@ using std::isfinite;
 #include "astreplacement.h"
 #include "CmdInfo.h"
 #include "tiledCanvas.h"
+#include "aggCanvas.h"
+#include "frameJobs.h"
 
 using namespace AST;
 
@@ -58,6 +64,98 @@ unsigned int RendererImpl::MaxMergeFiles = 0;      // maximum number of files to
 const double SHAPE_BORDER = 1.0; // multiplier of shape size when calculating bounding box
 const double FIXED_BORDER = 8.0; // fixed extra border, in pixels
 
+static agg::trans_affine_time
+frameWindow(const agg::trans_affine_time& timeBounds, int frames, int frame)
+// The time window of a zero-based animation frame. Each window starts where
+// the previous one ends.
+{
+    double frameInc = (timeBounds.tend - timeBounds.tbegin) / frames;
+    double begin = frame ? timeBounds.tbegin + frameInc * frame : timeBounds.tbegin;
+    return agg::trans_affine_time(1.0, begin, timeBounds.tbegin + frameInc * (frame + 1));
+}
+
+class FrameIndex
+// The finished shapes of an animation, indexed by the frames that they are
+// in. Each frame then only visits the shapes that overlap it, in the same
+// order as a full pass over the finished shapes. In memory this is a list of
+// live shapes that is carried from frame to frame. When the finished shapes
+// are in temp files they are respilled into files by the frame where they
+// start, and a frame only merges the files of its own and earlier frames.
+//
+// If no shape leaves before the last frame and shapes appear in z/order
+// order then each frame is the previous frame with the new shapes drawn on
+// top. Unless the animation zooms, the canvas is then carried over from the
+// previous frame and only the new shapes are drawn.
+{
+public:
+    FrameIndex(int frames, const agg::trans_affine_time& timeBounds, bool zoom,
+               RendererImpl& renderer);
+    FrameIndex& operator=(const FrameIndex&) = delete;
+    
+    void build(ShapeFunction visit);
+    // visit is called for every finished shape as it is indexed
+    void select(int frame);     // frame is zero-based
+    void forEach(ShapeFunction op);
+    bool carried() const { return mCarry; }
+    // whether the selected frame is drawn over the previous one
+    bool incremental() const { return mIncremental; }
+    // whether every frame can be drawn over the previous one
+    
+private:
+    struct Entry {
+        std::uint32_t   index;  // into mRenderer.mFinishedShapes
+        int             last;   // last frame that the shape is in
+    };
+    
+    bool frameRange(const FinishedShape& s, int& first, int& last) const;
+    void appendOnly(int first, int last);
+    int bucket(int frame) const { return static_cast<int>(
+        static_cast<std::int64_t>(frame) * mBuckets.size() / mFrames); }
+    
+    double                      mBegin;         // start time of the first frame
+    std::vector<double>         mEnds;          // end time of each frame
+    int                         mFrames;
+    int                         mFrame = -1;
+    bool                        mIncremental;   // frames can be drawn over
+    int                         mLastFirst = 0; // while checking mIncremental
+    bool                        mCarry = false; // mFrame is drawn over mFrame - 1
+    std::vector<std::vector<Entry>> mStarts;    // shapes by their first frame
+    std::vector<Entry>          mLive;          // shapes in mFrame
+    std::vector<TempFile>       mBuckets;       // shapes by first frame, for
+                                                // shapes in temp files
+    RendererImpl&               mRenderer;
+};
+
+class ExpansionCache
+// The children that shapes expanded to in earlier frames of a frame time
+// animation. A shape whose rules don't read ftime() or frame(), directly or
+// through functions and global variables, expands to the same children in
+// every frame that it has the same state and parameters in. Its cached
+// children are fed back to the renderer instead of traversing the rule
+// again, so culling and ordering are the same as for a fresh expansion.
+// Expansions that are not used in a frame are dropped at the end of it.
+{
+public:
+    explicit ExpansionCache(std::size_t maxShapes) : mMaxShapes(maxShapes) {}
+    ExpansionCache& operator=(const ExpansionCache&) = delete;
+    
+    static std::string key(const Shape& s);
+    const std::vector<Shape>* find(const std::string& key);
+    void insert(std::string&& key, const Shape& s, std::vector<Shape>&& children);
+    void endFrame();
+    
+private:
+    struct Expansion {
+        param_ptr           params;     // keeps parameters in the key alive
+        std::vector<Shape>  children;
+        bool                used = true;
+    };
+    
+    std::unordered_map<std::string, Expansion> mExpansions;
+    std::size_t mShapes = 0;            // children in mExpansions
+    std::size_t mMaxShapes;
+};
+
 RendererImpl::RendererImpl( const cfdg_ptr& cfdg,
                             int width, int height, double minSize,
                             int variation, double border)
@@ -67,7 +165,8 @@ RendererImpl::RendererImpl( const cfdg_ptr& cfdg,
       shapeCopies(primShape::shapeMap), shapeMap{}
 {
     assert(m_cfdg);
-    if (MoveFinishedAt == 0) {
+    static std::once_flag limitsSet;
+    std::call_once(limitsSet, [this]() {
 #ifndef DEBUG_SIZES
         std::size_t mem = m_cfdg->system()->getPhysicalMemory();
         if (mem == 0) {
@@ -81,7 +180,7 @@ RendererImpl::RendererImpl( const cfdg_ptr& cfdg,
         MoveUnfinishedAt   =     200; // when this many, move to files
         MaxMergeFiles      =       4; // maximum number of files to merge at once
 #endif
-    }
+    });
     
     for (std::size_t i = 0; i < shapeMap.size(); ++i)
         shapeMap[i] = CommandInfo(&shapeCopies[i]);
@@ -127,6 +226,7 @@ RendererImpl::init()
     
     m_minArea = 0.3; 
     m_outputSoFar = m_stats.shapeCount = m_stats.toDoCount = 0;
+    mBatchedCount = mPathCount = mPathCacheHits = 0;
     double minSize = m_minSize;
     m_cfdg->hasParameter(CFG::MinimumSize, minSize, this);
     minSize = (minSize <= 0.0) ? 0.3 : minSize;
@@ -154,7 +254,7 @@ RendererImpl::init()
     mCurrentPath = std::make_unique<AST::ASTcompiledPath>();
     
     m_cfdg->getSymmetry(mSymmetryOps, this);
-    m_cfdg->setBackgroundColor(this);
+    mBackgroundColor = m_cfdg->calcBackgroundColor(this);
 }
 
 void
@@ -207,6 +307,7 @@ void
 RendererImpl::cleanup()
 {
     // delete temp files before checking for abort
+    mFrameIndex.reset();
     m_finishedFiles.clear();
     m_unfinishedFiles.clear();
 
@@ -218,7 +319,7 @@ RendererImpl::cleanup()
     unwindStack(0, m_cfdg->mCFDGcontents.mParameters);
     
     mCurrentPath.reset();
-    m_cfdg->resetCachedPaths();
+    m_cfdg->resetCachedPaths(this);
 }
 
 void
@@ -227,6 +328,12 @@ RendererImpl::setMaxShapes(int n)
     m_maxShapes = n ? n : 400000000;
 }
 
+void
+RendererImpl::setFrameJobs(int n)
+{
+    mFrameJobs = n > 1 ? n : 1;
+}
+
 void
 RendererImpl::resetBounds()
 {
@@ -237,20 +344,11 @@ RendererImpl::resetBounds()
 void
 RendererImpl::outputPrep(Canvas* canvas)
 {
-    m_canvas = canvas;
+    attachCanvas(canvas);
 
     if (canvas) {
         m_width = canvas->mWidth;
         m_height = canvas->mHeight;
-        if (m_tiled || m_frieze) {
-            agg::trans_affine tr;
-            m_cfdg->isTiled(&tr);
-            m_cfdg->isFrieze(&tr);
-            m_tiledCanvas = std::make_unique<tiledCanvas>(canvas, tr, m_frieze);
-            m_tiledCanvas->scale(m_currScale);
-            m_canvas = m_tiledCanvas.get();
-        }
-
         mFrameTimeBounds.load_from(1.0, -Renderer::Infinity, Renderer::Infinity);
     }
     
@@ -263,6 +361,20 @@ RendererImpl::outputPrep(Canvas* canvas)
     m_stats.finalOutput = false;
 }
 
+void
+RendererImpl::attachCanvas(Canvas* canvas)
+{
+    m_canvas = canvas;
+
+    if (canvas && (m_tiled || m_frieze)) {
+        agg::trans_affine tr;
+        m_cfdg->isTiled(&tr);
+        m_cfdg->isFrieze(&tr);
+        m_tiledCanvas = std::make_unique<tiledCanvas>(canvas, tr, m_frieze);
+        m_tiledCanvas->scale(m_currScale);
+        m_canvas = m_tiledCanvas.get();
+    }
+}
 
 double
 RendererImpl::run(Canvas * canvas, bool partialDraw)
@@ -307,9 +419,7 @@ RendererImpl::run(Canvas * canvas, bool partialDraw)
         m_stats.toDoCount--;
         
         try {
-            const ASTrule* rule = m_cfdg->findRule(s.mShapeType, s.mWorldState.mRand64Seed.getDouble());
-            m_drawingMode = false;      // shouldn't matter
-            rule->traverseRule(s, this);
+            expand(s);
         } catch (CfdgError& e) {
             requestStop = true;
             system()->error();
@@ -483,6 +593,222 @@ OutputBounds::smooth(int window)
 }
 
 
+FrameIndex::FrameIndex(int frames, const agg::trans_affine_time& timeBounds,
+                       bool zoom, RendererImpl& renderer)
+: mBegin(frameWindow(timeBounds, frames, 0).tbegin), mFrames(frames),
+  mIncremental(!zoom), mRenderer(renderer)
+{
+    mEnds.reserve(frames);
+    for (int frame = 0; frame < frames; ++frame)
+        mEnds.push_back(frameWindow(timeBounds, frames, frame).tend);
+    if (!isfinite(mEnds.front()) || !isfinite(mEnds.back()))
+        mIncremental = false;
+}
+
+bool
+FrameIndex::frameRange(const FinishedShape& s, int& first, int& last) const
+// The frames whose time windows the shape overlaps, using the same test as
+// drawShape(). Frame f starts at the end of frame f - 1.
+{
+    if (!isfinite(mEnds.front()) || !isfinite(mEnds.back())) {
+        first = 0;
+        last = mFrames - 1;
+        return true;
+    }
+    
+    const agg::trans_affine_time& time = s.mWorldState.m_time;
+    first = static_cast<int>(std::lower_bound(mEnds.begin(), mEnds.end(), time.tbegin) -
+                             mEnds.begin());
+    last = static_cast<int>(std::upper_bound(mEnds.begin(), mEnds.end() - 1, time.tend) -
+                            mEnds.begin());
+    return first < mFrames && first <= last && !(time.tend < mBegin);
+}
+
+void
+FrameIndex::appendOnly(int first, int last)
+// Called for each shape in order, clears mIncremental if a shape leaves
+// before the last frame or appears before a shape that precedes it
+{
+    if (last < mFrames - 1 || first < mLastFirst)
+        mIncremental = false;
+    mLastFirst = first;
+}
+
+void
+FrameIndex::build(ShapeFunction visit)
+{
+    RendererImpl& r = mRenderer;
+    int first, last;
+    
+    if (r.m_finishedFiles.empty()) {
+        if (r.mFinishedShapes.size() > 10000)
+            r.system()->message("Sorting shapes...");
+        std::sort(r.mFinishedShapes.begin(), r.mFinishedShapes.end());
+        
+        mStarts.resize(mFrames);
+        std::uint32_t index = 0;
+        for (const FinishedShape& s: r.mFinishedShapes) {
+            visit(s);
+            if (frameRange(s, first, last)) {
+                mStarts[first].push_back({ index, last });
+                appendOnly(first, last);
+            }
+            ++index;
+        }
+        return;
+    }
+    
+    std::size_t buckets = std::min(static_cast<std::size_t>(mFrames),
+                                   static_cast<std::size_t>(RendererImpl::MaxMergeFiles));
+    std::vector<AbstractSystem::ostr_ptr> files;
+    mBuckets.reserve(buckets);
+    for (std::size_t i = 0; i < buckets; ++i) {
+        mBuckets.emplace_back(r.system(), AbstractSystem::ShapeTemp, ++r.mFinishedFileCount);
+        files.push_back(mBuckets.back().forWrite());
+        if (!files.back() || !files.back()->good()) {
+            r.system()->message("Cannot open temporary file for shapes");
+            r.requestStop = true;
+            throw Stopped();
+        }
+    }
+    
+    r.system()->message("Indexing shapes by frame");
+    r.forEachShape(true, [&](const FinishedShape& s) {
+        if (r.requestStop) throw Stopped();
+        visit(s);
+        if (frameRange(s, first, last)) {
+            *files[bucket(first)] << s;
+            appendOnly(first, last);
+        }
+    });
+}
+
+void
+FrameIndex::select(int frame)
+{
+    mCarry = mIncremental && mFrame >= 0 && frame == mFrame + 1;
+    if (!mBuckets.empty() || mCarry) {
+        mFrame = frame;
+        return;
+    }
+    
+    auto ended = [frame](const Entry& e) { return e.last < frame; };
+    auto byIndex = [](const Entry& a, const Entry& b) { return a.index < b.index; };
+    
+    if (frame == mFrame + 1 && !mIncremental) {
+        // Drop the shapes that ended in the previous frame and merge in the
+        // ones that start in this frame
+        mLive.erase(std::remove_if(mLive.begin(), mLive.end(), ended), mLive.end());
+        const std::vector<Entry>& starts = mStarts[frame];
+        std::vector<Entry> live;
+        live.reserve(mLive.size() + starts.size());
+        std::merge(mLive.begin(), mLive.end(), starts.begin(), starts.end(),
+                   std::back_inserter(live), byIndex);
+        mLive.swap(live);
+    } else {
+        mLive.clear();
+        for (int f = 0; f <= frame; ++f)
+            std::remove_copy_if(mStarts[f].begin(), mStarts[f].end(),
+                                std::back_inserter(mLive), ended);
+        std::sort(mLive.begin(), mLive.end(), byIndex);
+    }
+    mFrame = frame;
+}
+
+void
+FrameIndex::forEach(ShapeFunction op)
+{
+    if (mBuckets.empty()) {
+        for (const Entry& e: mCarry ? mStarts[mFrame] : mLive)
+            op(mRenderer.mFinishedShapes[e.index]);
+        return;
+    }
+    
+    OutputMerge merger;
+    if (mCarry) {
+        // The new shapes are all in this frame's file, skip the ones that
+        // were drawn in earlier frames
+        double drawn = mEnds[mFrame - 1];
+        merger.addTempFile(mBuckets[bucket(mFrame)]);
+        merger.merge([&](const FinishedShape& s) {
+            if (s.mWorldState.m_time.tbegin > drawn)
+                op(s);
+        });
+        return;
+    }
+    for (int b = 0; b <= bucket(mFrame); ++b)
+        merger.addTempFile(mBuckets[b]);
+    merger.merge(op);
+}
+
+std::string
+ExpansionCache::key(const Shape& s)
+// The bits of the shape type, state and parameter values. Parameters that
+// are shapes are compared by address.
+{
+    const Modification& m = s.mWorldState;
+    const double state[] = {
+        m.m_transform.sx, m.m_transform.shy, m.m_transform.shx,
+        m.m_transform.sy, m.m_transform.tx, m.m_transform.ty,
+        m.m_Z.sz, m.m_Z.tz, m.m_time.st, m.m_time.tbegin, m.m_time.tend,
+        m.m_Color.h, m.m_Color.s, m.m_Color.b, m.m_Color.a,
+        m.m_ColorTarget.h, m.m_ColorTarget.s, m.m_ColorTarget.b, m.m_ColorTarget.a
+    };
+    const std::int64_t flags[] = {
+        s.mShapeType, m.m_ColorAssignment, m.m_BlendMode
+    };
+    const StackRule* params = s.mParameters.get();
+    std::size_t paramSize = params ? sizeof(StackType) * params->mParamCount : 0;
+    
+    std::string k(sizeof state + sizeof flags + sizeof(Rand64) + paramSize, '\0');
+    char* pos = &k[0];
+    std::memcpy(pos, state, sizeof state);
+    pos += sizeof state;
+    std::memcpy(pos, flags, sizeof flags);
+    pos += sizeof flags;
+    std::memcpy(pos, &m.mRand64Seed, sizeof(Rand64));
+    pos += sizeof(Rand64);
+    if (paramSize)
+        std::memcpy(pos, reinterpret_cast<const StackType*>(params) + StackRule::HeaderSize,
+                    paramSize);
+    return k;
+}
+
+const std::vector<Shape>*
+ExpansionCache::find(const std::string& key)
+{
+    auto it = mExpansions.find(key);
+    if (it == mExpansions.end())
+        return nullptr;
+    it->second.used = true;
+    return &it->second.children;
+}
+
+void
+ExpansionCache::insert(std::string&& key, const Shape& s, std::vector<Shape>&& children)
+{
+    if (mShapes + children.size() > mMaxShapes)
+        return;
+    mShapes += children.size();
+    Expansion& e = mExpansions[std::move(key)];
+    e.params = s.mParameters;
+    e.children = std::move(children);
+}
+
+void
+ExpansionCache::endFrame()
+{
+    for (auto it = mExpansions.begin(); it != mExpansions.end();) {
+        if (it->second.used) {
+            it->second.used = false;
+            ++it;
+        } else {
+            mShapes -= it->second.children.size();
+            it = mExpansions.erase(it);
+        }
+    }
+}
+
 void
 RendererImpl::animate(Canvas* canvas, int frames, int frame, bool zoom)
 {
@@ -500,20 +826,24 @@ RendererImpl::animate(Canvas* canvas, int frames, int frame, bool zoom)
     
     outputPrep(canvas);
     
-    double frameInc = (mTimeBounds.tend - mTimeBounds.tbegin) / frames;
+    // Running a frame of a frame time animation changes mTimeBounds
+    const agg::trans_affine_time timeBounds = mTimeBounds;
     
     OutputBounds outputBounds(frames, mTimeBounds, curr_width, curr_height, *this);
     if (!ftime) {
         system()->message("Computing zoom");
 
         try {
-            forEachShape(true, [&](const FinishedShape& s) {
+            // The frame bounds are gathered in the same pass over the
+            // finished shapes that indexes them by frame
+            auto index = std::make_unique<FrameIndex>(frames, mTimeBounds, zoom, *this);
+            index->build([&](const FinishedShape& s) {
                 outputBounds.apply(s);
             });
-            m_outputSoFar = 0;  // gets set by forEachShape, must be cleared
             //outputBounds.finalAccumulate();
             outputBounds.backwardFilter(10.0);
             //outputBounds.smooth(3);
+            mFrameIndex = std::move(index);
         } catch (Stopped&) {
             m_stats.animating = false;
             return;
@@ -525,9 +855,21 @@ RendererImpl::animate(Canvas* canvas, int frames, int frame, bool zoom)
 
     m_stats.shapeCount = 0;
     m_stats.animating = true;
-    mFrameTimeBounds.tend = mTimeBounds.tbegin;
     
     Bounds saveBounds = mBounds;
+    
+    // Frames are recorded here and rasterized on other threads, unless each
+    // frame is drawn over the previous one
+    std::unique_ptr<frameJobs> jobs;
+    aggCanvas* rasterCanvas = dynamic_cast<aggCanvas*>(canvas);
+    if (mFrameJobs > 1 && frame == 0 && frames > 1 && rasterCanvas &&
+        (ftime || !mFrameIndex->incremental()))
+    {
+        jobs = std::make_unique<frameJobs>(rasterCanvas, mFrameJobs);
+    }
+
+    if (ftime && frame == 0 && frames > 1)
+        mExpansions = std::make_unique<ExpansionCache>(MoveUnfinishedAt);
 
     for (int frameCount = 1; frameCount <= frames; ++frameCount)
     {
@@ -536,8 +878,9 @@ RendererImpl::animate(Canvas* canvas, int frames, int frame, bool zoom)
         
         if (zoom) mBounds = outputBounds.frameBounds(frameCount - 1);
         m_stats.shapeCount += outputBounds.frameCount(frameCount - 1);
-        mFrameTimeBounds.tbegin = mFrameTimeBounds.tend;
-        mFrameTimeBounds.tend = mTimeBounds.tbegin + frameInc * frameCount;
+        mFrameTimeBounds = frameWindow(timeBounds, frames, frameCount - 1);
+        if (jobs)
+            attachCanvas(jobs->next());
         
         if (ftime) {
             mCurrentTime = (mFrameTimeBounds.tbegin + mFrameTimeBounds.tend) * 0.5;
@@ -548,19 +891,31 @@ RendererImpl::animate(Canvas* canvas, int frames, int frame, bool zoom)
                 system()->error();
                 system()->syntaxError(err);
                 cleanup();
+                if (jobs) {
+                    jobs->finish();
+                    attachCanvas(canvas);
+                }
                 mBounds = saveBounds;
+                mExpansions.reset();
                 m_stats.animating = false;
                 outputStats();
                 return;
             }
             run(canvas, false);
         } else {
+            mFrameIndex->select(frameCount - 1);
             outputFinal();
             outputStats();
         }
         
         if (ftime)
             cleanup();
+        if (mExpansions)
+            mExpansions->endFrame();
+        
+        if (jobs)
+            jobs->submit();
+        m_stats.outputStall = canvas->mStallTime;
         
         if (canvas->mError) {
             system()->message("An error occurred generating frame %d", frameCount);
@@ -569,17 +924,61 @@ RendererImpl::animate(Canvas* canvas, int frames, int frame, bool zoom)
 
         if (requestStop || requestFinishUp) break;
     }
+    
+    if (jobs) {
+        jobs->finish();
+        jobs.reset();
+        attachCanvas(canvas);
+        m_stats.outputStall = canvas->mStallTime;
+    }
 
     mBounds = saveBounds;
+    mFrameIndex.reset();
+    mExpansions.reset();
     m_stats.animating = false;
     outputStats();
     if (frame == 0)
         system()->message("Animation of %d frames complete", frames);
 }
 
+void
+RendererImpl::expand(Shape& s)
+{
+    const ASTrule* rule = m_cfdg->findRule(s.mShapeType, s.mWorldState.mRand64Seed.getDouble());
+    m_drawingMode = false;      // shouldn't matter
+    if (!mExpansions || rule->isPath || m_cfdg->shapeReadsFrameTime(s.mShapeType)) {
+        rule->traverseRule(s, this);
+        return;
+    }
+    
+    std::string key = ExpansionCache::key(s);
+    if (const std::vector<Shape>* children = mExpansions->find(key)) {
+        for (const Shape& child: *children) {
+            if (requestStop) break;
+            Shape copy(child);
+            processShape(copy);
+        }
+        return;
+    }
+    
+    std::vector<Shape> children;
+    mRecording = &children;
+    try {
+        rule->traverseRule(s, this);
+    } catch (...) {
+        mRecording = nullptr;
+        throw;
+    }
+    if (mRecording && !requestStop)
+        mExpansions->insert(std::move(key), s, std::move(children));
+    mRecording = nullptr;
+}
+
 void
 RendererImpl::processShape(Shape& s)
 {
+    if (mRecording)
+        mRecording->push_back(s);
     double area = s.area();
     if (!s.mWorldState.isFinite()) {
         requestStop = true;
@@ -702,7 +1101,7 @@ RendererImpl::processPrimShapeSiblings(Shape&& s, const ASTrule* path)
     // Drop shapes outside the current frame if we are animating and rerunning
     // the cfdg file for every frame.
     if (!m_cfdg->usesFrameTime || fs.mWorldState.m_time.overlaps(mFrameTimeBounds))
-        mFinishedShapes.push_back(fs);
+        mFinishedShapes.push_back(std::move(fs));
 }
 
 void
@@ -719,6 +1118,7 @@ RendererImpl::processSubpath(const Shape& s, bool tr, int expectedType)
     }
     if (static_cast<int>(rule->mRuleBody.mRepType) != expectedType)
         throw CfdgError(rule->mLocation, "Subpath is not of the expected type (path ops/commands)");
+    mRecording = nullptr;   // not an expansion that can be replayed
     bool saveOpsOnly = mOpsOnly;
     mOpsOnly = mOpsOnly || (expectedType == ASTreplacement::op);
     rule->mRuleBody.traverse(s, tr, this, true);
@@ -934,7 +1334,9 @@ void RendererImpl::rescaleOutput(int& curr_width, int& curr_height, bool final)
 void
 RendererImpl::forEachShape(bool final, ShapeFunction op)
 {
-    if (!final || m_finishedFiles.empty()) {
+    if (final && mFrameIndex) {
+        mFrameIndex->forEach(op);
+    } else if (!final || m_finishedFiles.empty()) {
         FinishedContainer::iterator start = mFinishedShapes.begin();
         FinishedContainer::iterator last  = mFinishedShapes.end();
         if (!final)
@@ -1006,11 +1408,18 @@ RendererImpl::drawShape(const FinishedShape& s)
     if (s.mShapeType != primShape::fillType && (!isfinite(a) || a < m_minArea))
         return;
     
-    if (m_tiledCanvas && s.mShapeType != primShape::fillType) {
+    if (s.mShapeType != primShape::fillType) {
+        // Skip shapes that lie entirely outside of the canvas (or outside of
+        // every tile of a tiled canvas)
         Bounds b = s.mBounds;
         m_currTrans.transform(&b.mMin_X, &b.mMin_Y);
         m_currTrans.transform(&b.mMax_X, &b.mMax_Y);
-        m_tiledCanvas->tileTransform(b);
+        if (m_tiledCanvas ? !m_tiledCanvas->tileTransform(b)
+                          : !b.overlaps(mCanvasBounds))
+        {
+            m_stats.culledCount++;
+            return;
+        }
     }
 
     if (m_cfdg->getShapeType(s.mShapeType) == CFDGImpl::pathType) {
@@ -1055,14 +1464,28 @@ void RendererImpl::output(bool final)
     
     m_stats.outputDone = m_outputSoFar;
     
-    if (final) {
+    if (final && !mFrameIndex) {    // the frame index sorts them once
         if (mFinishedShapes.size() > 10000)
             system()->message("Sorting shapes...");
         std::sort(mFinishedShapes.begin(), mFinishedShapes.end());
     }
     
-    m_canvas->start(m_outputSoFar == 0, m_cfdg->getBackgroundColor(),
+    if (m_outputSoFar == 0)
+        m_stats.culledCount = 0;
+    
+    // An incremental animation frame is drawn over the previous frame
+    bool carried = final && mFrameIndex && mFrameIndex->carried();
+    m_canvas->start(m_outputSoFar == 0 && !carried, mBackgroundColor,
         curr_width, curr_height);
+    
+    // The output is centered on the canvas, so the visible area can extend
+    // past the output size. Pad it for anti-aliasing.
+    double visibleX = (m_canvas->mWidth - curr_width) / 2.0 + FIXED_BORDER;
+    double visibleY = (m_canvas->mHeight - curr_height) / 2.0 + FIXED_BORDER;
+    mCanvasBounds.mMin_X = -visibleX;
+    mCanvasBounds.mMin_Y = -visibleY;
+    mCanvasBounds.mMax_X = curr_width + visibleX;
+    mCanvasBounds.mMax_Y = curr_height + visibleY;
 
     m_drawingMode = true;
     //OutputDraw draw(*this, final);
@@ -1085,6 +1508,9 @@ void RendererImpl::output(bool final)
 void
 RendererImpl::outputStats()
 {
+    m_stats.batchedCount = mBatchedCount;
+    m_stats.pathCount = mPathCount;
+    m_stats.pathCacheHits = mPathCacheHits;
     system()->stats(m_stats);
     requestUpdate = false;
 }
@@ -1101,7 +1527,16 @@ RendererImpl::processPathCommand(const Shape& s, const AST::CommandInfo* attr)
         }
     } else {
         if (attr) {
-            mPathBounds.update(s.mWorldState.m_transform, m_pathIter, mScale, *attr);
+            if (s.mShapeType < primShape::fillType && attr == &shapeMap[s.mShapeType])
+                mPathBounds.update(s.mWorldState.m_transform, shapeCopies[s.mShapeType]);
+            else if (mCurrentPath && mCurrentPath->mCached &&
+                     ((attr->mFlags & CF_FILL) || !(attr->mFlags & CF_ISO_WIDTH)))
+                // A path replayed from the cache is bounded from its hull,
+                // which is reused by instances that are flattened alike
+                mPathBounds.update(s.mWorldState.m_transform,
+                                   m_pathIter.localHull(s.mWorldState.m_transform, *attr, mScale));
+            else
+                mPathBounds.update(s.mWorldState.m_transform, m_pathIter, mScale, *attr);
             mCurrentArea = fabs((mPathBounds.mMax_X - mPathBounds.mMin_X) *
                                 (mPathBounds.mMax_Y - mPathBounds.mMin_Y));
         }
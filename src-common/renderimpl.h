@@ -37,6 +37,7 @@
 #include <deque>
 #include <set>
 #include <array>
+#include <memory>
 #include <type_traits>
 
 #include "agg2/agg_trans_affine.h"
@@ -52,6 +53,8 @@
 #include "chunk_vector.h"
 
 class ShapeOp;
+class FrameIndex;
+class ExpansionCache;
 namespace AST {
     class ASTbodyContainer;
     class ASTrule;
@@ -67,6 +70,7 @@ class RendererImpl final : public RendererAST {
         ~RendererImpl() override;
     
         void setMaxShapes(int n) final;
+        void setFrameJobs(int n) final;
         void resetBounds() final;
         void resetSize(int x, int y) final;
         void initBounds();
@@ -78,12 +82,15 @@ class RendererImpl final : public RendererAST {
         void processShape(Shape& s) final;
         void processPrimShape(Shape& s, const AST::ASTrule* path = nullptr) final;
         void processSubpath(const Shape& s, bool tr, int) final;
+        const agg::rgba& backgroundColor() const { return mBackgroundColor; }
         
     private:
         void outputPrep(Canvas*);
+        void attachCanvas(Canvas*);
         void rescaleOutput(int& curr_width, int& curr_height, bool final);
         void forEachShape(bool final, ShapeFunction op);
         void processPrimShapeSiblings(Shape&& s, const AST::ASTrule* path);
+        void expand(Shape& s);
         void drawShape(const FinishedShape& s);
 
         void output(bool final);
@@ -94,6 +101,7 @@ class RendererImpl final : public RendererAST {
         friend class OutputDraw;
         friend class OutputMerge;
         friend class OutputBounds;
+        friend class FrameIndex;
         
         bool isDone();
         void fileIfNecessary();
@@ -114,6 +122,7 @@ class RendererImpl final : public RendererAST {
         bool        mColorConflict = false;
 
         int m_maxShapes;
+        int mFrameJobs = 1;     // animation frames rasterized at once
         bool m_tiled = false;
         bool m_sized = false;
         bool m_timed = false;
@@ -131,6 +140,13 @@ class RendererImpl final : public RendererAST {
         std::deque<TempFile> m_unfinishedFiles;
         int mFinishedFileCount = 0;
         int mUnfinishedFileCount = 0;
+        std::unique_ptr<FrameIndex> mFrameIndex;    // finished shapes by frame,
+                                                    // while animating
+        std::unique_ptr<ExpansionCache> mExpansions;    // rule expansions of
+                                                    // earlier frames, while
+                                                    // animating frame time
+        std::vector<Shape>* mRecording = nullptr;   // children of the shape
+                                                    // being expanded
 
         int mVariation = 0;
         double m_border;
@@ -153,9 +169,11 @@ class RendererImpl final : public RendererAST {
         agg::trans_affine_time mTimeBounds;
         agg::trans_affine_time mFrameTimeBounds;
         agg::trans_affine m_currTrans;
+        Bounds mCanvasBounds;   // visible canvas area, in pixels
         unsigned int m_outputSoFar = 0;
     
         std::vector<agg::trans_affine> mSymmetryOps;
+        agg::rgba mBackgroundColor;
 
         AbstractSystem::Stats m_stats;
         int m_unfinishedInFilesCount = 0;
@@ -80,9 +80,7 @@ Modification::merge(const Modification& m)
                     (m_Color.a != 0.0 && m.m_Color.a != 0.0);
     if (conflict) return true;
     
-    m_transform.premultiply(m.m_transform);
-    m_Z.premultiply(m.m_Z);
-    m_time.premultiply(m.m_time);
+    premultiplyTransforms(*this, m);
     mRand64Seed ^= m.mRand64Seed;
     if (m.m_BlendMode)
         m_BlendMode = m.m_BlendMode;
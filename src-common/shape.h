@@ -60,6 +60,16 @@ class Modification {
         Rand64 mRand64Seed;
 
         Modification() = default;
+        Modification(const Modification& a, const Modification& m)
+        // a * m, composed straight into the new object
+        : m_Color(a.m_Color), m_ColorTarget(a.m_ColorTarget),
+          m_ColorAssignment(a.m_ColorAssignment),
+          m_BlendMode(m.m_BlendMode ? m.m_BlendMode : a.m_BlendMode),
+          mRand64Seed(a.mRand64Seed)
+        {
+            premultiplyTransforms(a, m);
+            adjust(m);
+        }
     
         double area() const { return fabs(m_transform.determinant()); }
         bool isFinite() const;
@@ -72,18 +82,47 @@ class Modification {
         }
         Modification& operator*=(const Modification& m)
         {
-            m_transform.premultiply(m.m_transform);
-            m_Z.premultiply(m.m_Z);
-            m_time.premultiply(m.m_time);
-            HSBColor::Adjust(m_Color, m_ColorTarget, m.m_Color, m.m_ColorTarget,
-                             m.m_ColorAssignment);
-            mRand64Seed ^= m.mRand64Seed;
+            premultiplyTransforms(*this, m);
+            adjust(m);
             if (m.m_BlendMode)
                 m_BlendMode = m.m_BlendMode;
             return *this;
         }
     
     bool merge(const Modification& m);
+
+    private:
+        void adjust(const Modification& m)
+        {
+            if (!m.m_Color.isZero() || !m.m_ColorTarget.isZero())
+                HSBColor::Adjust(m_Color, m_ColorTarget, m.m_Color, m.m_ColorTarget,
+                                 m.m_ColorAssignment);
+            mRand64Seed ^= m.mRand64Seed;
+        }
+        void premultiplyTransforms(const Modification& a, const Modification& m)
+        // Sets the geometry, Z and time transforms to those of a premultiplied
+        // by those of m, in one pass. a can be this. The arithmetic is the
+        // same as agg's premultiply(), which is out of line and copies each
+        // transform twice.
+        {
+            const agg::trans_affine& t = a.m_transform;
+            const agg::trans_affine& u = m.m_transform;
+            double sx  = u.sx  * t.sx  + u.shy * t.shx;
+            double shx = u.shx * t.sx  + u.sy  * t.shx;
+            double tx  = u.tx  * t.sx  + u.ty  * t.shx + t.tx;
+            double shy = u.sx  * t.shy + u.shy * t.sy;
+            double sy  = u.shx * t.shy + u.sy  * t.sy;
+            double ty  = u.tx  * t.shy + u.ty  * t.sy  + t.ty;
+            double sz = m.m_Z.sz * a.m_Z.sz;
+            double tz = m.m_Z.tz * a.m_Z.sz + a.m_Z.tz;
+            double st = m.m_time.st * a.m_time.st;
+            double tbegin = m.m_time.tbegin * a.m_time.st + a.m_time.tbegin;
+            double tend = m.m_time.tend * a.m_time.st + a.m_time.tend;
+            m_transform.sx = sx;   m_transform.shx = shx; m_transform.tx = tx;
+            m_transform.shy = shy; m_transform.sy = sy;   m_transform.ty = ty;
+            m_Z.sz = sz; m_Z.tz = tz;
+            m_time.st = st; m_time.tbegin = tbegin; m_time.tend = tend;
+        }
 };
 
 class ShapeBase {
@@ -96,6 +135,12 @@ public:
 protected:
     ShapeBase() 
     { mAreaCache = mWorldState.area(); }
+    ShapeBase(int type, const Modification& a, const Modification& m)
+    : mShapeType(type), mWorldState(a, m), mAreaCache(mWorldState.area())
+    { }
+    ShapeBase(int type, const Modification& w)
+    : mShapeType(type), mWorldState(w), mAreaCache(mWorldState.area())
+    { }
     
     void write(std::ostream& os) const;
     void read(std::istream& is);
@@ -110,6 +155,14 @@ public:
     Shape(Shape&& s) noexcept
     : ShapeBase(s), mParameters(std::move(s.mParameters))
     { }
+    Shape(int type, const Modification& worldState, const Modification& m,
+          param_ptr params) noexcept
+    : ShapeBase(type, worldState, m), mParameters(std::move(params))
+    { }
+        // a child shape with worldState * m as its world state
+    Shape(int type, const Modification& worldState, param_ptr params) noexcept
+    : ShapeBase(type, worldState), mParameters(std::move(params))
+    { }
     ~Shape() = default;
     Shape& operator=(const Shape& o) {
         if (this == &o) return *this;
@@ -161,7 +214,7 @@ public:
         mShapeType = s.mShapeType;
         mWorldState = s.mWorldState;
         mWorldState.m_ColorAssignment = static_cast<unsigned>(order);
-        mParameters = s.mParameters;
+        mParameters = std::move(s.mParameters);
         mBounds = b;
     }
     FinishedShape(const FinishedShape&) = default;
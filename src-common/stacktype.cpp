@@ -137,8 +137,9 @@ void
 StackRule::release() const noexcept
 {
     assert(mRefCount > 0);
-    if (mRefCount < MaxRefCount)
-        --mRefCount;
+    std::uint32_t count = mRefCount.load(std::memory_order_relaxed);
+    if (count < MaxRefCount)
+        count = mRefCount.fetch_sub(1, std::memory_order_acq_rel) - 1;
     
 #ifdef EXTREME_PARAM_DEBUG
     auto f = ParamMap.find(this);
@@ -148,7 +149,7 @@ StackRule::release() const noexcept
     if (n == ParamOfInterest)
         (*f).second = ParamOfInterest;
 #endif
-    if (mRefCount == 0) {
+    if (count == 0) {
         auto data = reinterpret_cast<const StackType*>(this);
         if (mParamCount)
             data[HeaderSize].destroy(data[1].typeInfo);
@@ -184,8 +185,8 @@ StackRule::retain() const noexcept
     if (n == ParamOfInterest)
         (*f).second = ParamOfInterest;
 #endif
-    if (mRefCount != MaxRefCount)
-        ++mRefCount;                // After 4+ billion refs this causes a leak
+    if (mRefCount.load(std::memory_order_relaxed) != MaxRefCount)
+        mRefCount.fetch_add(1, std::memory_order_relaxed);  // After 4+ billion refs this causes a leak
 }
 
 bool
@@ -206,6 +207,20 @@ StackRule::Equal(const StackRule* a, const StackRule* b)
     return (*a) == (*b);
 }
 
+std::size_t
+StackRule::Hash(const StackRule* a)
+{
+    // FNV-1a over the bytes that operator==() compares
+    std::uint64_t h = 14695981039346656037ULL;
+    if (a == nullptr) return static_cast<std::size_t>(h);
+    auto p = reinterpret_cast<const unsigned char*>(a + HeaderSize);
+    for (std::size_t i = 0, e = sizeof(StackType) * a->mParamCount; i < e; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(h ^ a->mParamCount);
+}
+
 void
 StackRule::read(std::istream& is)
 {
@@ -294,7 +309,7 @@ EvalArgs(RendererAST* rti, const StackRule* parent, StackType::iterator& dest,
             rti->mLogicalStackTop = &(*dest);
         switch (arg.mType) {
             case AST::NumericType: {
-                int num = arg.evaluate(&(dest->number), dest.type().mTuplesize, rti);
+                int num = arg.evaluateLowered(&(dest->number), dest.type().mTuplesize, rti);
                 if (dest.type().isNatural && !RendererAST::isNatural(rti, dest->number))
                     CfdgError::Error(arg.where, "Expression does not evaluate to a legal natural number");
                 if (num != dest.type().mTuplesize)
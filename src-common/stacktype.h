@@ -30,6 +30,7 @@
 #endif
 #include <cstdint>
 #include <vector>
+#include <atomic>
 #include <iosfwd>
 #include "ast.h"
 
@@ -154,10 +155,12 @@ struct StackRule {
     
     std::int16_t     mRuleName;
     std::uint16_t    mParamCount;
-    mutable std::uint32_t    mRefCount;
+    mutable std::atomic<std::uint32_t> mRefCount;  // shared across renderer threads
     
     bool operator==(const StackRule& o) const;
     static bool Equal(const StackRule* a, const StackRule* b);
+    static std::size_t Hash(const StackRule* a);
+        // Equal parameters have equal hashes
     
     static StackRule*  alloc(int name, int size, const AST::ASTparameters* ti);
     static StackRule*  alloc(const StackRule* from, int newName = -1);
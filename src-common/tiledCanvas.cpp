@@ -77,10 +77,11 @@ tiledCanvas::checkTile(const Bounds& b, const agg::rect_d& canvas, double dx, do
     return hit;
 }
 
-void
+bool
 tiledCanvas::tileTransform(const Bounds& b)
 // Compute a list of tiling offsets for all tiled copies of the shape that overlap
-// the canvas. Used for subsequent drawing.
+// the canvas. Used for subsequent drawing. Returns false if none of the copies
+// overlap the canvas.
 {
     double centx = (b.mMin_X + b.mMax_X) * 0.5;
     double centy = (b.mMin_Y + b.mMax_Y) * 0.5;
@@ -93,6 +94,8 @@ tiledCanvas::tileTransform(const Bounds& b)
     mOffset.transform(&dx, &dy);
     mTileList.emplace_back(dx, dy);
     agg::rect_d canvas(-5, -5, static_cast<double>(mWidth + 9), static_cast<double>(mHeight + 9));
+    agg::rect_d center(b.mMin_X + dx, b.mMin_Y + dy, b.mMax_X + dx, b.mMax_Y + dy);
+    bool visible = center.overlaps(canvas);
     
     if (mFrieze)
         centx = centy = centx + centy;      // one will be zero, set them both to the other one
@@ -112,7 +115,8 @@ tiledCanvas::tileTransform(const Bounds& b)
             }
         }
         
-        if (!hit) return;
+        if (!hit) return visible;
+        visible = true;
     }
 }
 
@@ -100,7 +100,7 @@ int Variation::recommendedMax(int letters)
 
 int Variation::random(int letters)
 {
-    static bool seeded = false;
+    static thread_local bool seeded = false;
     if (!seeded) {
         std::random_device rd;
         Rand64::result_type seed = rd();
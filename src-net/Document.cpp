@@ -1871,7 +1871,7 @@ void Document::setupCanvas(Renderer* r)
         int height = renderParams->action == RenderParameters::RenderActions::Render ?
             renderParams->height : renderParams->animateHeight;
         mCanvas = new WinCanvas(mSystem, WinCanvas::SuggestPixelFormat(mEngine->get()), 
-            width, height, (*mEngine)->getBackgroundColor());
+            width, height, (*mEngine)->getBackgroundColor(r));
     }
 }
 
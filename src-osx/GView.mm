@@ -805,7 +805,7 @@ namespace {
     
     agg::rgba backgroundColor(1.0, 1.0, 1.0, 1.0);
     if (mEngine && mRenderer)
-        backgroundColor = mEngine->getBackgroundColor();
+        backgroundColor = mEngine->getBackgroundColor(mRenderer.get());
     
     if (backgroundColor.opacity() < 1.0) {
         [self drawCheckerboardRect: rect];
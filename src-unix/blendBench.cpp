@@ -0,0 +1,182 @@
+// blendBench.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// Times each blend mode through the agg custom blend pixel format and
+// through every set of blendSpans kernels that this CPU supports, for both
+// 8-bit and 16-bit color. Also reports the largest difference from agg,
+// in units of the least significant bit. Build with "make blendbench".
+
+#include "blendSpans.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    const struct { const char* name; agg::comp_op_e op; } BlendModes[] = {
+        {"Normal",      agg::comp_op_src_over},
+        {"Clear",       agg::comp_op_clear},
+        {"Xor",         agg::comp_op_xor},
+        {"Plus",        agg::comp_op_plus},
+        {"Multiply",    agg::comp_op_multiply},
+        {"Screen",      agg::comp_op_screen},
+        {"Overlay",     agg::comp_op_overlay},
+        {"Darken",      agg::comp_op_darken},
+        {"Lighten",     agg::comp_op_lighten},
+        {"ColorDodge",  agg::comp_op_color_dodge},
+        {"ColorBurn",   agg::comp_op_color_burn},
+        {"HardLight",   agg::comp_op_hard_light},
+        {"SoftLight",   agg::comp_op_soft_light},
+        {"Difference",  agg::comp_op_difference},
+        {"Exclusion",   agg::comp_op_exclusion},
+    };
+
+    const int Width = 1024;
+    const int Height = 256;
+    const int Passes = 8;
+
+    template<class T>
+    void fillDest(std::vector<T>& buf, unsigned mask)
+    // Premultiplied gradients with alpha going from clear to opaque
+    {
+        for (int y = 0; y < Height; ++y)
+            for (int x = 0; x < Width; ++x) {
+                T* p = &buf[(y * Width + x) * 4];
+                unsigned a = mask * (x % 97) / 96;
+                p[0] = static_cast<T>(a * (y % 61) / 60);
+                p[1] = static_cast<T>(a * ((x + y) % 83) / 82);
+                p[2] = static_cast<T>(a * (x % 31) / 30);
+                p[3] = static_cast<T>(a);
+            }
+    }
+
+    std::vector<agg::cover_type> makeCovers()
+    // Mostly full coverage with anti-aliased edges, like a rasterized shape
+    {
+        std::vector<agg::cover_type> covers(Width);
+        for (int x = 0; x < Width; ++x)
+            covers[x] = static_cast<agg::cover_type>(x % 64 < 3 ? x % 64 * 80 + 15 : agg::cover_full);
+        return covers;
+    }
+
+    template<class Color>
+    Color sourceColor(int y)
+    {
+        agg::rgba c(0.2 + 0.6 * (y % 7) / 6.0, 0.5, 0.9 - 0.8 * (y % 5) / 4.0, 0.4 + 0.6 * (y % 3) / 2.0);
+        return Color(c.premultiply());
+    }
+
+    template<class PixFmt>
+    double runAgg(std::vector<typename PixFmt::value_type>& buf, agg::comp_op_e op,
+                  const std::vector<agg::cover_type>& covers)
+    {
+        using color_type = typename PixFmt::color_type;
+        agg::rendering_buffer rbuf(reinterpret_cast<agg::int8u*>(buf.data()), Width, Height,
+                                   Width * 4 * sizeof(typename PixFmt::value_type));
+        PixFmt pixf(rbuf, op);
+        auto start = std::chrono::steady_clock::now();
+        for (int y = 0; y < Height; ++y)
+            pixf.blend_solid_hspan(0, y, Width, sourceColor<color_type>(y), covers.data());
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<class Color, class T, class Fn>
+    double runKernel(std::vector<T>& buf, Fn fn, const std::vector<agg::cover_type>& covers)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (int y = 0; y < Height; ++y) {
+            Color c = sourceColor<Color>(y);
+            float color[4] = {
+                static_cast<float>(Color::to_double(c.r)), static_cast<float>(Color::to_double(c.g)),
+                static_cast<float>(Color::to_double(c.b)), static_cast<float>(Color::to_double(c.a))
+            };
+            fn(&buf[y * Width * 4], Width, color, covers.data(), agg::cover_full);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    template<class T>
+    int maxDiff(const std::vector<T>& a, const std::vector<T>& b)
+    {
+        int diff = 0;
+        for (size_t i = 0; i < a.size(); ++i)
+            diff = std::max(diff, std::abs(static_cast<int>(a[i]) - static_cast<int>(b[i])));
+        return diff;
+    }
+
+    template<class Color>
+    void bench(const char* title, unsigned mask)
+    {
+        using T = typename Color::value_type;
+        using blender = agg::comp_op_adaptor_rgba_pre<Color, agg::order_rgba>;
+        using pixfmt = agg::pixfmt_custom_blend_rgba<blender, agg::rendering_buffer>;
+        const double pixels = double(Width) * Height * Passes / 1e6;
+
+        std::vector<const blendSpans::Kernels*> sets;
+        for (auto isa: {blendSpans::Isa::SSE41, blendSpans::Isa::AVX2})
+            if (auto k = blendSpans::kernels(isa))
+                sets.push_back(k);
+
+        std::printf("\n%s, Mpixel/s (max difference from agg in LSB)\n%-12s %10s", title, "blend", "agg");
+        for (auto k: sets)
+            std::printf(" %16s", k->name);
+        std::printf("\n");
+
+        auto covers = makeCovers();
+        std::vector<T> dest(Width * Height * 4), ref, buf;
+        fillDest(dest, mask);
+        for (auto& mode: BlendModes) {
+            double t = 0.0;
+            for (int pass = 0; pass < Passes; ++pass) {
+                ref = dest;
+                t += runAgg<pixfmt>(ref, mode.op, covers);
+            }
+            std::printf("%-12s %10.1f", mode.name, pixels / t);
+            for (auto k: sets) {
+                auto fn = blendSpans::kernel(*k, 1, mode.op, static_cast<T*>(nullptr));
+                if (!fn) {
+                    std::printf(" %16s", "-");
+                    continue;
+                }
+                t = 0.0;
+                for (int pass = 0; pass < Passes; ++pass) {
+                    buf = dest;
+                    t += runKernel<Color>(buf, fn, covers);
+                }
+                std::printf(" %10.1f (%3d)", pixels / t, maxDiff(ref, buf));
+            }
+            std::printf("\n");
+        }
+    }
+}
+
+int main()
+{
+    auto k = blendSpans::best();
+    std::printf("blendSpans uses %s\n", k ? k->name : "agg");
+    bench<agg::rgba8>("8-bit color", 255);
+    bench<agg::rgba16>("16-bit color", 65535);
+    return EXIT_SUCCESS;
+}
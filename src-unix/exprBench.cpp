@@ -0,0 +1,89 @@
+// exprBench.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+// Times the expansion of each design given on the command line with
+// expressions evaluated by the tree walker and by the bytecode interpreter.
+// Nothing is drawn, so the times are mostly expression evaluation and shape
+// bookkeeping. Build with "make exprbench".
+
+#include "cfdg.h"
+#include "commandLineSystem.h"
+#include "astbytecode.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    const int Passes = 3;
+    const int Variation = 1;
+
+    double timeDesign(const char* fname, bool lowering)
+    // Best time of several passes, in milliseconds, or -1 on error. Parsing
+    // is not timed.
+    {
+        AST::ASTbytecode::Lowering = lowering;
+        CommandLineSystem system(true);
+
+        double best = -1.0;
+        for (int pass = 0; pass < Passes; ++pass) {
+            // A design can only make one renderer
+            cfdg_ptr design = CFDG::ParseFile(fname, &system, Variation);
+            if (!design)
+                return -1.0;
+            renderer_ptr renderer = design->renderer(design, 500, 500, 0.3, Variation);
+            if (!renderer)
+                return -1.0;
+            auto start = std::chrono::steady_clock::now();
+            renderer->run(nullptr, false);
+            std::chrono::duration<double, std::milli> t = std::chrono::steady_clock::now() - start;
+            if (best < 0.0 || t.count() < best)
+                best = t.count();
+        }
+        return best;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: exprbench design.cfdg ...\n");
+        return 1;
+    }
+
+    std::printf("%-32s %10s %10s %8s\n", "design", "tree ms", "vm ms", "speedup");
+    int errors = 0;
+    for (int i = 1; i < argc; ++i) {
+        double tree = timeDesign(argv[i], false);
+        double vm = timeDesign(argv[i], true);
+        if (tree < 0.0 || vm < 0.0) {
+            std::printf("%-32s failed\n", argv[i]);
+            ++errors;
+            continue;
+        }
+        std::printf("%-32s %10.1f %10.1f %7.2fx\n", argv[i], tree, vm,
+                    tree / std::max(vm, 0.001));
+    }
+    return errors ? 2 : 0;
+}
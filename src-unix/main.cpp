@@ -44,6 +44,7 @@
 #endif
 #include "SVGCanvas.h"
 #include "ffCanvas.h"
+#include "rawVideoCanvas.h"
 #include "commandLineSystem.h"
 #include "version.h"
 #include "Rand64.h"
@@ -51,6 +52,12 @@
 #include <cassert>
 #include <memory>
 #include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
 #include "astexpression.h"
 #include "prettyint.h"
 
@@ -64,10 +71,18 @@ void cleanupTimer();
 std::ostream* myCout = &cerr;
 
 static std::weak_ptr<Renderer> gRenderer;
+static std::atomic<bool> gBatchRunning(false);
 
 static bool processInterrupt()
 {
     auto TheRenderer = gRenderer.lock();
+    if (!TheRenderer && gBatchRunning) {
+        if (Renderer::AbortEverything)
+            exit(9);
+        Renderer::AbortEverything = true;
+        cerr << endl << "Batch interrupted, skipping the remaining variations" << endl;
+        return true;
+    }
     if (!TheRenderer) return false;
     
     if (!TheRenderer->requestFinishUp) {
@@ -102,7 +117,8 @@ void termination_handler(int)
 
 
 struct options {
-    enum OutputFormat { PNGfile = 0, SVGfile = 1, MOVfile = 2, BMPfile = 3, JSONfile = 4 };
+    enum OutputFormat { PNGfile = 0, SVGfile = 1, MOVfile = 2, BMPfile = 3, JSONfile = 4,
+                        VideoFile = 5 };
     int   width;
     int   height;
     int   widthMult;
@@ -113,14 +129,19 @@ struct options {
     std::string definitions;
     
     int   variation;
+    std::vector<int> variations;    // batch mode if there are several
+    int   jobs;
     bool  crop;
     bool  check;
+    bool  batch;
     int   animationFrames;
     int   animationTime;
     int   animationFPS;
     bool  animationZoom;
     int   animateFrame;
+    int   frameJobs;
     ffCanvas::QTcodec animationCodec;
+    rawVideoCanvas::VideoFormat videoFormat;
     
     std::string input;
     std::string output;
@@ -134,14 +155,17 @@ struct options {
     bool outputWallpaper;
     bool paramTest;
     bool deleteTemps;
+    bool floatAccum;
+    bool fastMath;
     
     options()
     : width(500), height(500), widthMult(1), heightMult(1), maxShapes(0), 
-      minSize(0.3F), borderSize(2.0F), variation(-1), crop(false), check(false), 
-      animationFrames(0), animationTime(0), animationFPS(15), animationZoom(false), 
-      animateFrame(0), animationCodec(ffCanvas::H264), format(PNGfile), quiet(false),
+      minSize(0.3F), borderSize(2.0F), variation(-1), jobs(0), crop(false), check(false),
+      batch(false), animationFrames(0), animationTime(0), animationFPS(15), animationZoom(false), 
+      animateFrame(0), frameJobs(1), animationCodec(ffCanvas::H264),
+      videoFormat(rawVideoCanvas::Y4M), format(PNGfile), quiet(false),
       outputTime(false), outputStdout(false), outputTemp(false), outputWallpaper(false),
-      paramTest(false), deleteTemps(false)
+      paramTest(false), deleteTemps(false), floatAccum(false), fastMath(false)
     { }
 };
 
@@ -208,8 +232,13 @@ processCommandLine(int argc, char* argv[], options& opt)
                                        "-1=-8 pixel border, 0=no border, 1=8 pixel "
                                        "border, 2=variable-sized border",
                                        {'b', "bordersize"}, 2.0);
-    args::ValueFlag<string> variation(parser, "VARIATION",
-        "Set the variation code (default is random)", {'v', "variation"}, "");
+    args::ValueFlag<string> variation(parser, "VARIATION or FIRST..LAST",
+        "Set the variation code (default is random), a range of codes renders "
+        "each variation in the range", {'v', "variation"}, "");
+    args::ValueFlag<string> variationsFile(parser, "FILE", "Render each variation "
+        "code listed in FILE, one per line", {"variations-file"}, "");
+    args::ValueFlag<int> jobs(parser, "JOBS", "Number of variations to render at "
+        "once when rendering several (default is one per processor)", {'j', "jobs"}, 0);
     args::ValueFlagList<string> definition(parser, "NAME=VALUE",
         "Define a variable, configuration, or function. Overrides definitions in the input file.", {'D'});
     args::ValueFlag<string> outputFileTemplate(parser, "NAME TEMPLATE",
@@ -221,12 +250,16 @@ processCommandLine(int argc, char* argv[], options& opt)
         {'a',"animate"}, "");
     args::ValueFlag<int> frame(parser, "FRAME", "Animate a particular frame", {'f', "frame"}, 0);
     args::Flag zoom(parser, "zoom", "Zoom out during animation", {'z', "zoom"});
+    args::ValueFlag<int> frameJobs(parser, "JOBS", "Number of animation frames to "
+                                   "rasterize at once", {"frame-jobs"}, 1);
     args::Flag makeSVG(parser, "SVG", "Generate SVG output (not allowed for animation)",
                        {'V', "svg"});
     args::Flag makeJSON(parser, "JSON", "Generate JSON output of parsed cfdg file",
                        {'J', "json"});
     args::Flag makeQT(parser, "quicktime", "Make QuickTime output", {'Q', "quicktime"});
     args::Flag makeProRes(parser, "ProRes", "Use ProRes codec for QuickTime output", { "prores" });
+    args::ValueFlag<string> video(parser, "y4m or rgba", "Stream the animation as "
+                                  "YUV4MPEG2 or raw RGBA video", {"video"});
 #ifdef _WIN32
     args::Flag wallpaper(parser, "wallpaper", "Generate desktop wallpaper output",
                          {'W', "wallpaper"});
@@ -235,6 +268,10 @@ processCommandLine(int argc, char* argv[], options& opt)
 #endif
     args::ValueFlag<string> display(parser, "display executable", "Display output with specified program", {"display"}, "");
     args::Flag crop(parser, "crop", "Crop output", {'c', "crop"});
+    args::Flag floatAccum(parser, "float", "Render in floating point and dither to the "
+                          "output bit depth (PNG output only)", {'F', "float"});
+    args::Flag fastMath(parser, "fast math", "Use faster sin, cos, tan, cot, and exp "
+                        "functions that can differ in the last few digits", {"fast-math"});
     args::Flag quiet(parser, "quiet", "Quiet mode, suppress non-error output", {'q', "quiet"});
     args::Flag check(parser, "check", "Check syntax of cfdg file and exit", {'C', "check"});
     args::Flag timer(parser, "time", "Output the time taken to render the cfdg file", {'t', "time"});
@@ -285,9 +322,61 @@ processCommandLine(int argc, char* argv[], options& opt)
             bailout("Border size must be between -1 and 2");
     }
     if (variation) {
-        opt.variation = Variation::fromString(args::get(variation).c_str());
-        if (opt.variation == -1)
-            bailout("Error parsing variation");
+        const std::string& code = args::get(variation);
+        auto range = code.find("..");
+        if (range == std::string::npos) {
+            opt.variation = Variation::fromString(code.c_str());
+            if (opt.variation == -1)
+                bailout("Error parsing variation");
+        } else {
+            int first = Variation::fromString(code.substr(0, range).c_str());
+            int last = Variation::fromString(code.substr(range + 2).c_str());
+            if (first < 1 || last < first)
+                bailout("Error parsing variation range");
+            for (int v = first; v <= last; ++v)
+                opt.variations.push_back(v);
+        }
+    }
+    if (variationsFile) {
+        if (variation)
+            bailout("Variation codes are given on the command line and in a file.");
+        std::ifstream codes(args::get(variationsFile));
+        if (!codes)
+            bailout("Cannot open the variations file.");
+        std::string line;
+        while (std::getline(codes, line)) {
+            auto begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos)
+                continue;
+            auto end = line.find_last_not_of(" \t\r");
+            int v = Variation::fromString(line.substr(begin, end - begin + 1).c_str());
+            if (v == -1)
+                bailout("Error parsing variation in the variations file");
+            opt.variations.push_back(v);
+        }
+        if (opt.variations.empty())
+            bailout("The variations file has no variation codes.");
+    }
+    if (!opt.variations.empty()) {
+        opt.variation = opt.variations.front();
+        opt.batch = variationsFile || opt.variations.size() > 1;
+    }
+    if (jobs) {
+        if (!opt.batch)
+            bailout("Jobs are only available when rendering several variations.");
+        opt.jobs = args::get(jobs);
+        if (opt.jobs < 1)
+            bailout("Jobs must be a positive integer.");
+    }
+    if (opt.batch) {
+        if (animation || makeJSON || wallpaper || display)
+            bailout("Several variations can only be rendered to PNG or SVG files.");
+        if ((!outputFile || args::get(outputFile) == "-") && !outputFileTemplate)
+            bailout("Several variations need an output file name.");
+        if (outputFileTemplate &&
+            args::get(outputFileTemplate).find("%v") == string::npos &&
+            args::get(outputFileTemplate).find("%V") == string::npos)
+            bailout("The output file template must include %v or %V when rendering several variations.");
     }
     if (definition) {
         auto defs = definition.Get();
@@ -327,8 +416,19 @@ processCommandLine(int argc, char* argv[], options& opt)
             bailout("FFmpeg DLLs not found, QuickTime output is unavailable.");
         if (makeProRes && !makeQT)
             bailout("ProRes codec only available with QuickTime output.");
-        if (frame) {
+        if (video) {
             if (makeQT)
+                bailout("Video stream output cannot be QuickTime output.");
+            if (args::get(video) == "y4m")
+                opt.videoFormat = rawVideoCanvas::Y4M;
+            else if (args::get(video) == "rgba")
+                opt.videoFormat = rawVideoCanvas::RawRGBA;
+            else
+                bailout("Video stream format must be y4m or rgba.");
+            opt.format = options::VideoFile;
+        }
+        if (frame) {
+            if (makeQT || video)
                 bailout("Single frame animation only outputs PNG files.");
             opt.animateFrame = args::get(frame);
             if (opt.animateFrame < 1)
@@ -336,6 +436,11 @@ processCommandLine(int argc, char* argv[], options& opt)
             if (opt.animateFrame > opt.animationFrames)
                 bailout("Animation frame is after the end of the animation.");
         }
+        if (frameJobs) {
+            opt.frameJobs = args::get(frameJobs);
+            if (opt.frameJobs < 1)
+                bailout("Frame jobs must be a positive integer.");
+        }
     } else {
         if (makeQT)
             bailout("QuickTime output is only available when animating.");
@@ -343,6 +448,10 @@ processCommandLine(int argc, char* argv[], options& opt)
             bailout("Zoomed output is only available when animating.");
         if (frame)
             bailout("Animation frame can only be rendered when animating.");
+        if (frameJobs)
+            bailout("Frame jobs are only available when animating.");
+        if (video)
+            bailout("Video stream output is only available when animating.");
     }
     if (makeSVG) opt.format = options::SVGfile;
     if (wallpaper) {
@@ -352,7 +461,11 @@ processCommandLine(int argc, char* argv[], options& opt)
         opt.outputWallpaper = true;
     }
     if (makeJSON) opt.format = options::JSONfile;
+    if (floatAccum && (makeSVG || makeQT || makeJSON))
+        bailout("Floating point rendering is only available for PNG and video stream output.");
     opt.crop = crop;
+    opt.floatAccum = floatAccum;
+    opt.fastMath = fastMath;
     opt.check = check;
     opt.quiet = quiet;
     opt.outputTime = timer;
@@ -372,13 +485,19 @@ processCommandLine(int argc, char* argv[], options& opt)
         for (char c: args::get(outputFile)) {
             opt.output.append(c == '%' ? 2 : 1, c);
         }
-        if (opt.animationFrames && opt.animateFrame == 0 && opt.format != options::MOVfile) {
+        const char* suffix = nullptr;
+        if (opt.animationFrames && opt.animateFrame == 0 && opt.format != options::MOVfile &&
+            opt.format != options::VideoFile)
+            suffix = "_%f";
+        if (opt.batch)
+            suffix = "_%V";
+        if (suffix) {
             std::size_t ext = opt.output.find_last_of('.');
             std::size_t dir = opt.output.find_last_of(APP_DIRCHAR());
             if (ext != string::npos && (dir == string::npos || ext > dir)) {
-                opt.output.insert(ext, "_%f");
+                opt.output.insert(ext, suffix);
             } else {
-                opt.output.append("_%f");
+                opt.output.append(suffix);
             }
         }
     }
@@ -417,6 +536,134 @@ namespace {
 }
 
 
+namespace {
+    struct BatchResult {
+        int variation = 0;
+        bool ok = false;
+        double expandTime = 0.0;    // msec
+        double drawTime = 0.0;      // msec
+    };
+
+    using msec = std::chrono::duration<double, std::milli>;
+
+    BatchResult
+    renderVariation(const options& opts, cfdg_ptr design, int variation,
+                    AbstractSystem* system, std::mutex& parseMutex)
+    {
+        BatchResult res;
+        res.variation = variation;
+        
+        // rand_static() is drawn while parsing, so such a design is parsed
+        // again for each variation
+        if (design->usesRandStatic && variation != opts.variation) {
+            std::lock_guard<std::mutex> lock(parseMutex);
+            design = CFDG::ParseFile(opts.input.c_str(), system, variation,
+                                     opts.definitions);
+            if (!design) return res;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        renderer_ptr renderer = design->renderer(design, opts.width, opts.height,
+                                                 opts.minSize, variation,
+                                                 opts.borderSize);
+        if (!renderer) return res;
+        if (opts.maxShapes > 0)
+            renderer->setMaxShapes(opts.maxShapes);
+        renderer->run(nullptr, false);
+        auto expanded = std::chrono::steady_clock::now();
+        
+        int width = renderer->m_width;
+        int height = renderer->m_height;
+        bool crop = opts.crop && !(design->isTiled() || design->isFrieze());
+        bool error = true;
+        if (opts.format == options::SVGfile) {
+            string name = makeCFfilename(opts.output.c_str(), 0, 0, variation);
+            SVGCanvas svg(name.c_str(), width, height, crop);
+            if (!svg.mError) {
+                renderer->draw(&svg);
+                error = svg.mError;
+            }
+        } else {
+            aggCanvas::PixelFormat pixfmt = aggCanvas::SuggestPixelFormat(design.get());
+            if (opts.floatAccum)
+                pixfmt = static_cast<aggCanvas::PixelFormat>(pixfmt | aggCanvas::Has_Float_Accum);
+            pngCanvas png(opts.output.c_str(), true, width, height, pixfmt, crop, 0,
+                          variation, false, renderer.get(), opts.widthMult,
+                          opts.heightMult, false);
+            if (png.mWidth != width || png.mHeight != height)
+                renderer->resetSize(png.mWidth, png.mHeight);
+            renderer->draw(&png);
+            error = png.mError;
+        }
+        
+        res.ok = !error && !renderer->requestStop && !Renderer::AbortEverything;
+        res.expandTime = msec(expanded - start).count();
+        res.drawTime = msec(std::chrono::steady_clock::now() - expanded).count();
+        return res;
+    }
+}
+
+static int
+renderBatch(const options& opts, const cfdg_ptr& design, AbstractSystem* system)
+{
+    // Renders every variation in opts.variations from a pool of threads that
+    // share the parsed design
+    std::mutex parseMutex;
+    std::vector<BatchResult> results(opts.variations.size());
+    std::atomic<std::size_t> next(0);
+    
+    unsigned jobs = opts.jobs > 0 ? static_cast<unsigned>(opts.jobs)
+                                  : std::max(std::thread::hardware_concurrency(), 1U);
+    jobs = std::min(jobs, static_cast<unsigned>(results.size()));
+    
+    *myCout << "Rendering " << results.size() << " variations on " << jobs
+            << (jobs == 1 ? " thread" : " threads")
+            << (design->usesRandStatic ? ", parsing each variation" : "")
+            << "..." << endl;
+    
+    gBatchRunning = true;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned i = 0; i < jobs; ++i)
+        pool.emplace_back([&]() {
+            for (std::size_t v = next++; v < results.size(); v = next++) {
+                if (Renderer::AbortEverything) {
+                    results[v].variation = opts.variations[v];
+                    continue;
+                }
+                results[v] = renderVariation(opts, design, opts.variations[v],
+                                             system, parseMutex);
+            }
+        });
+    for (auto& worker: pool)
+        worker.join();
+    double total = msec(std::chrono::steady_clock::now() - start).count();
+    gBatchRunning = false;
+    
+    int failed = 0;
+    *myCout << endl << "Variation   Expand ms    Draw ms  Output file" << endl;
+    for (auto&& res: results) {
+        string code = Variation::toString(res.variation, false);
+        if (!res.ok) {
+            ++failed;
+            *myCout << code << std::string(code.length() < 9 ? 9 - code.length() : 0, ' ')
+                    << "     failed" << endl;
+            continue;
+        }
+        char times[32];
+        std::snprintf(times, sizeof(times), "%11.1f%11.1f", res.expandTime, res.drawTime);
+        *myCout << code << std::string(code.length() < 9 ? 9 - code.length() : 0, ' ')
+                << times << "  "
+                << makeCFfilename(opts.output.c_str(), 0, 0, res.variation) << endl;
+    }
+    *myCout << "Rendered " << results.size() - failed << " of " << results.size()
+            << " variations in " << prettyInt(static_cast<unsigned long>(total))
+            << " msec." << endl;
+    
+    Renderer::AbortEverything = true;   // skip parameter clean-up at exit
+    return failed ? 5 : 0;
+}
+
 int main (int argc, char* argv[]) {
     options opts;
     int var = Variation::random(6);
@@ -445,7 +692,8 @@ int main (int argc, char* argv[]) {
     if (opts.variation < 0) opts.variation = var;
     std::string code = Variation::toString(opts.variation, false);
     
-    CommandLineSystem system(opts.quiet);
+    // Renderers in a batch run at once, so their progress is not shown
+    CommandLineSystem system(opts.quiet || opts.batch);
     
     if (!opts.quiet || opts.deleteTemps) {
         auto temps = system.findTempFiles();
@@ -473,10 +721,15 @@ int main (int argc, char* argv[]) {
     }
     
     AST::ASTfunction::RandStaticIsConst = opts.format != options::JSONfile;
+    AST::ASTfunction::FastMath = opts.fastMath;
     cfdg_ptr myDesign = CFDG::ParseFile(opts.input.c_str(), &system,
                                         opts.variation, opts.definitions);
     if (!myDesign) return 3;
-    if (opts.check) return 0;
+    if (opts.check) {
+        system.message("%d unreachable rules and %d dead branches pruned",
+                       myDesign->prunedRules, myDesign->prunedBranches);
+        return 0;
+    }
     if (opts.format == options::JSONfile) {
         std::unique_ptr<std::ostream, OstreamCloser> out(nullptr);
         if (opts.outputStdout)
@@ -496,16 +749,22 @@ int main (int argc, char* argv[]) {
             return 6;
         }
     }
+    if (opts.batch)
+        return renderBatch(opts, myDesign, &system);
 
     bool useRGBA = myDesign->usesColor;
     aggCanvas::PixelFormat pixfmt = aggCanvas::SuggestPixelFormat(myDesign.get());
     bool use16bit = (pixfmt & aggCanvas::Has_16bit_Color) != 0;
     bool usecustom = (pixfmt & aggCanvas::Has_Custom_Blend) != 0;
-    const char* fmtnames[4] = { "PNG image", "SVG vector output", "Quicktime movie", "Wallpaper BMP image" };
+    if (opts.floatAccum)
+        pixfmt = static_cast<aggCanvas::PixelFormat>(pixfmt | aggCanvas::Has_Float_Accum);
+    const char* fmtnames[6] = { "PNG image", "SVG vector output", "Quicktime movie", 
+                                "Wallpaper BMP image", "JSON output", "video stream" };
     
     *myCout << "Generating " << (use16bit ? "16bit " : "8bit ") 
         << (useRGBA ? "color" : "gray-scale")
         << (usecustom ? ", custom blend" : "")
+        << (opts.floatAccum ? ", floating point" : "")
         << ' ' << fmtnames[opts.format]
         << ", variation " 
         << code << "..." << endl;
@@ -516,6 +775,7 @@ int main (int argc, char* argv[]) {
     std::unique_ptr<pngCanvas> png;
     std::unique_ptr<SVGCanvas> svg;
     std::unique_ptr<ffCanvas>  mov;
+    std::unique_ptr<rawVideoCanvas> vid;
     Canvas* myCanvas = nullptr;
         
     std::shared_ptr<Renderer> TheRenderer(myDesign->renderer(myDesign,
@@ -532,6 +792,8 @@ int main (int argc, char* argv[]) {
     
     if (opts.maxShapes > 0)
         TheRenderer->setMaxShapes(opts.maxShapes);
+    if (opts.frameJobs > 1)
+        TheRenderer->setFrameJobs(opts.frameJobs);
         
     if (opts.animationFrames == 0)
         TheRenderer->run(nullptr, false);
@@ -577,6 +839,19 @@ int main (int argc, char* argv[]) {
             myCanvas = static_cast<Canvas*>(mov.get());
             break;
         }
+        case options::VideoFile: {
+            vid = std::make_unique<rawVideoCanvas>(opts.output.c_str(), opts.quiet,
+                                                   opts.width, opts.height, pixfmt,
+                                                   opts.animationFrames, opts.variation,
+                                                   TheRenderer.get(), opts.animationFPS,
+                                                   opts.videoFormat);
+            if (vid->mErrorMsg) {
+                cerr << "Failed to create video file: " << vid->mErrorMsg << endl;
+                exit(8);
+            }
+            myCanvas = static_cast<Canvas*>(vid.get());
+            break;
+        }
         case options::JSONfile:
             break;
     }
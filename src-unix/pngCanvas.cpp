@@ -27,6 +27,7 @@
 //
 
 #include "pngCanvas.h"
+#include "colorPalette.h"
 #include "png.h"
 #include <cstdlib>
 #include <cstring>
@@ -55,6 +56,41 @@ namespace {
 }
 
 namespace {
+    void
+    setPalette(png_structp png_ptr, png_infop info_ptr, colorPalette& palette, int bpp)
+    // Translucent colors go first so that the tRNS chunk is as short as possible
+    {
+        auto alpha = [bpp](agg::int64u pixel) {
+            agg::int8u p[4] = { 0, 0, 0, 255 };
+            colorPalette::unpack(pixel, p, bpp);
+            return p[3];
+        };
+        if (bpp == 4)
+            palette.sort([&](agg::int64u a, agg::int64u b) {
+                return (alpha(a) < 255) > (alpha(b) < 255);
+            });
+        
+        png_color colors[colorPalette::MaxColors];
+        png_byte trans[colorPalette::MaxColors];
+        int numTrans = 0;
+        int numColors = 0;
+        for (agg::int64u pixel: palette.colors()) {
+            agg::int8u p[4] = { 0, 0, 0, 255 };
+            colorPalette::unpack(pixel, p, bpp);
+            agg::rgba8 pix(p[0], p[1], p[2], p[3]);
+            pix.demultiply();   // PNG palettes are not premultiplied
+            colors[numColors].red = pix.r;
+            colors[numColors].green = pix.g;
+            colors[numColors].blue = pix.b;
+            trans[numColors++] = pix.a;
+            if (pix.a < 255)
+                numTrans = numColors;
+        }
+        png_set_PLTE(png_ptr, info_ptr, colors, numColors);
+        if (numTrans)
+            png_set_tRNS(png_ptr, info_ptr, trans, numTrans, nullptr);
+    }
+    
     struct FileCloser
     {
         void operator()(std::FILE* ptr) const {
@@ -148,10 +184,30 @@ void pngCanvas::output(const char* outfilename, int frame)
                  << prettyInt(static_cast<unsigned long>(height)) << "h pixel image..." << endl;
         } 
         
-        png_set_IHDR(png_ptr, info_ptr,
-            width, height, (mPixelFormat & Has_16bit_Color) + 8, pngFormat,
-            PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
-            PNG_FILTER_TYPE_DEFAULT);
+        png_bytep rowPtr = mData.data() + srcy * mStride + srcx * aggCanvas::BytesPerPixel.at(mPixelFormat);
+        
+        // 8-bit color images with at most 256 colors are written with a palette
+        std::unique_ptr<colorPalette> palette;
+        if (pngFormat != PNG_COLOR_TYPE_GRAY && !(mPixelFormat & Has_16bit_Color)) {
+            int bpp = aggCanvas::BytesPerPixel.at(mPixelFormat);
+            palette = std::make_unique<colorPalette>(rowPtr, width, height, mStride, bpp);
+            if (!palette->fits())
+                palette.reset();
+        }
+        
+        if (palette) {
+            std::size_t colors = palette->colors().size();
+            int depth = colors <= 2 ? 1 : colors <= 4 ? 2 : colors <= 16 ? 4 : 8;
+            png_set_IHDR(png_ptr, info_ptr, width, height, depth, PNG_COLOR_TYPE_PALETTE,
+                PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                PNG_FILTER_TYPE_DEFAULT);
+            setPalette(png_ptr, info_ptr, *palette, aggCanvas::BytesPerPixel.at(mPixelFormat));
+        } else {
+            png_set_IHDR(png_ptr, info_ptr,
+                width, height, (mPixelFormat & Has_16bit_Color) + 8, pngFormat,
+                PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+                PNG_FILTER_TYPE_DEFAULT);
+        }
 
         char myKey[] = "Software", myValue[] = "Context Free";
         
@@ -165,10 +221,14 @@ void pngCanvas::output(const char* outfilename, int frame)
             comments, sizeof(comments)/sizeof(comments[0]));
 
         png_write_info(png_ptr, info_ptr);
+        if (palette)
+            png_set_packing(png_ptr);   // one index per byte in, packed out
 
-        png_bytep rowPtr = mData.data() + srcy * mStride + srcx * aggCanvas::BytesPerPixel.at(mPixelFormat);
         for (int r = 0; r < height; ++r) {
-            if (mPixelFormat == aggCanvas::RGBA8_Blend || mPixelFormat == aggCanvas::RGBA8_Custom_Blend) {
+            if (palette) {
+                palette->indexRow(rowPtr, width, row.get());
+                png_write_row(png_ptr, row.get());
+            } else if (mPixelFormat == aggCanvas::RGBA8_Blend || mPixelFormat == aggCanvas::RGBA8_Custom_Blend) {
                 // Convert each row to non-premultiplied alpha as per PNG spec
                 // This is done in a separate array instead of in-situ because
                 // for animations the main buffer might be drawn into again
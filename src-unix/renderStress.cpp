@@ -0,0 +1,132 @@
+// renderStress.cpp
+// this file is part of Context Free
+// ---------------------
+// Copyright (C) 2019 John Horigan - john@glyphic.com
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+//
+// John Horigan can be contacted at john@glyphic.com or at
+// John Horigan, 1209 Villa St., Mountain View, CA 94041-1123, USA
+//
+//
+
+
+// Renders several variations of each design given on the command line, first
+// one at a time and then from a pool of threads that share the parsed design,
+// and checks that every image comes out the same both ways. Build with
+// "make renderstress", add SANITIZE=thread to run it under ThreadSanitizer.
+
+#include "cfdg.h"
+#include "aggCanvas.h"
+#include "commandLineSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+    const int Size = 200;
+
+    class memoryCanvas : public aggCanvas {
+    public:
+        memoryCanvas()
+        : aggCanvas(RGBA8_Blend), mData(Size * Size * 4)
+        {
+            mWidth = Size;
+            mHeight = Size;
+            attach(mData.data(), Size, Size, Size * 4);
+        }
+        std::uint64_t checksum() const;
+    private:
+        std::vector<unsigned char> mData;
+    };
+
+    std::uint64_t
+    memoryCanvas::checksum() const
+    {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (unsigned char c: mData)
+            hash = (hash ^ c) * 0x100000001b3ULL;
+        return hash;
+    }
+
+    std::uint64_t renderVariation(const cfdg_ptr& design, int variation)
+    // Checksum of one image, or 0 if the design would not render
+    {
+        renderer_ptr renderer = design->renderer(design, Size, Size, 0.3, variation);
+        if (!renderer)
+            return 0;
+        memoryCanvas canvas;
+        renderer->run(&canvas, false);
+        return canvas.checksum();
+    }
+
+    bool stressDesign(const char* fname, int variations, unsigned threads)
+    {
+        CommandLineSystem system(true);
+        cfdg_ptr design = CFDG::ParseFile(fname, &system, 1);
+        if (!design)
+            return false;
+
+        std::vector<std::uint64_t> serial(variations);
+        for (int v = 0; v < variations; ++v)
+            serial[v] = renderVariation(design, v + 1);
+
+        std::vector<std::uint64_t> parallel(variations);
+        std::atomic<int> next(0);
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+            pool.emplace_back([&]() {
+                for (int v = next++; v < variations; v = next++)
+                    parallel[v] = renderVariation(design, v + 1);
+            });
+        for (auto& t: pool)
+            t.join();
+
+        bool same = true;
+        for (int v = 0; v < variations; ++v) {
+            if (serial[v] && serial[v] == parallel[v])
+                continue;
+            std::printf("%s: variation %d differs\n", fname, v + 1);
+            same = false;
+        }
+        return same;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: renderstress design.cfdg ...\n"
+                             "environment: STRESS_VARIATIONS (16), STRESS_THREADS (4)\n");
+        return 1;
+    }
+    const char* env = std::getenv("STRESS_VARIATIONS");
+    int variations = env ? std::max(std::atoi(env), 1) : 16;
+    env = std::getenv("STRESS_THREADS");
+    unsigned threads = env ? static_cast<unsigned>(std::max(std::atoi(env), 1)) : 4;
+
+    int errors = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (stressDesign(argv[i], variations, threads))
+            std::printf("%s: %d variations on %u threads ok\n", argv[i], variations, threads);
+        else
+            ++errors;
+    }
+    return errors ? 2 : 0;
+}